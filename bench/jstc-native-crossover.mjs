@@ -0,0 +1,41 @@
+// Measures where native.checkPrimitives starts beating a compiled JS checker.
+// Run after `pnpm build && pnpm build:native`:
+//   node bench/jstc-native-crossover.mjs
+// The result feeds NATIVE_PRIMITIVE_MIN_ARGS in src/jstc/index.ts.
+
+import JSTC, { native, TYPEOF_BITS } from "../dist/jstc/index.js";
+
+if (!native) {
+  console.error("[bench] jstc native addon not found, run `pnpm build:native` first.");
+  process.exit(1);
+}
+
+const widths = [1, 2, 4, 8, 16, 32, 64, 128, 256, 1024];
+const types = ["string", "number", "boolean|undefined", "bigint"];
+
+function timeNsPerCall(fn, iterations) {
+  for (let i = 0; i < Math.min(iterations, 10_000); i++) fn();
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < iterations; i++) fn();
+  return Number(process.hrtime.bigint() - start) / iterations;
+}
+
+const rows = [];
+let crossover = null;
+for (const width of widths) {
+  const schema = Array.from({ length: width }, (_, i) => types[i % types.length]);
+  const args = Array.from({ length: width }, (_, i) => ["s", 1, true, 1n][i % 4]);
+  const masks = new Uint8Array(
+    schema.map((t) => t.split("|").reduce((m, p) => m | TYPEOF_BITS[p], 0)),
+  );
+  const compiled = JSTC.compile(schema);
+  const iterations = Math.max(5_000, Math.floor(2_000_000 / width));
+
+  const js = timeNsPerCall(() => compiled(...args), iterations);
+  const nat = timeNsPerCall(() => native.checkPrimitives(args, masks), iterations);
+  rows.push({ width, jsNs: Math.round(js), nativeNs: Math.round(nat), speedup: +(js / nat).toFixed(2) });
+  if (crossover === null && nat < js) crossover = width;
+}
+
+console.table(rows);
+console.log(JSON.stringify({ benchmark: "jstc-native-crossover", crossover, rows }));
@@ -0,0 +1,329 @@
+// TS vs native benchmark suite for every module.
+// Run after `pnpm build && pnpm build:native`:
+//   node benchmark.mjs [--filter color] [--samples 30] [--sample-ms 10] [--warmup-ms 200]
+//                      [--json] [--out results.json]
+//                      [--baseline results.json] [--max-regression 10]
+//
+// Every case runs twice, each time in a fresh child process: "ts" with
+// BRIKLAB_NATIVE=0 and "native" with the addons loaded (and the jstc routing
+// threshold lowered to 1 so its kernels are actually used). A case is warmed
+// up, its batch size calibrated to --sample-ms, and then timed for --samples
+// batches. ns/op percentiles come from those samples.
+//
+// With --baseline, the run exits with code 1 when any case lost more than
+// --max-regression percent (default 10) ops/sec against the baseline file,
+// which is the JSON written by --out or printed by --json.
+
+import { spawnSync } from "node:child_process";
+import fs from "node:fs";
+import { fileURLToPath } from "node:url";
+
+const argv = process.argv.slice(2);
+const flag = (name) => argv.includes(name);
+const option = (name, fallback) => {
+  const i = argv.indexOf(name);
+  return i >= 0 && i + 1 < argv.length ? argv[i + 1] : fallback;
+};
+
+const settings = {
+  filter: option("--filter", ""),
+  samples: Math.max(5, Number(option("--samples", 30))),
+  sampleMs: Math.max(1, Number(option("--sample-ms", 10))),
+  warmupMs: Math.max(0, Number(option("--warmup-ms", 200))),
+};
+
+// -------------------------------------------------------------------------------------------------------
+//#region Cases
+async function loadCases() {
+  const { default: Color, ColorBuffer, native: colorNative } = await import("./dist/color/index.js");
+  const { default: JSTC, native: jstcNative } = await import("./dist/jstc/index.js");
+  const { InlineStyle, StyleSheet, native: stylesheetNative } = await import("./dist/stylesheet/index.js");
+  const { Warner, OutputSink, native: warnerNative } = await import("./dist/warner/index.js");
+  const { CLI, native: cliNative } = await import("./dist/cli-john/index.js");
+  const { nativeInfo } = await import("./dist/native/load.js");
+
+  const natives = {
+    color: Boolean(colorNative),
+    jstc: Boolean(jstcNative),
+    stylesheet: Boolean(stylesheetNative),
+    warner: Boolean(warnerNative),
+    "cli-john": Boolean(cliNative),
+  };
+
+  const colorInputs = ["#ff8800", "rgb(12, 34, 56)", "rgba(255, 0, 128, 0.5)", "hsl(210, 50%, 40%)", "rebeccapurple"];
+  const colorBatch = Array.from({ length: 1000 }, (_, i) => colorInputs[i % colorInputs.length]);
+  const colorOut = new Float32Array(colorBatch.length * 4);
+  const orange = new Color("#ff8800");
+  const palette = ColorBuffer.from(Array.from({ length: 10000 }, (_, i) => colorInputs[i % colorInputs.length]));
+  const paletteOut = new ColorBuffer(palette.length);
+  const contrastOut = new Float32Array(palette.length);
+
+  const narrowTypes = ["number", "string", "boolean"];
+  const narrowArgs = [1, "a", true];
+  const wideTypes = Array.from({ length: 32 }, (_, i) => ["string", "number", "boolean|undefined"][i % 3]);
+  const wideArgs = Array.from({ length: 32 }, (_, i) => ["s", 1, true][i % 3]);
+  const rowSchema = JSTC.compile(["string", "number", "number", "boolean", "string|undefined", "number", "string", "boolean"]);
+  const rows = Array.from({ length: 1000 }, (_, i) => [`r${i}`, i, i / 2, i % 2 === 0, undefined, -i, "x", false]);
+
+  const style = new InlineStyle({ color: "red", fontWeight: "bold", marginLeft: "4px", display: "flex" });
+  let flip = false;
+  const sheet = new StyleSheet();
+  for (let i = 0; i < 50; i++) {
+    sheet.set(`.rule-${i}`, new InlineStyle({ color: colorInputs[i % colorInputs.length], padding: `${i}px` }));
+  }
+  const theme = new StyleSheet();
+  for (let i = 0; i < 10000; i++) {
+    theme.set(`.theme-${i} > a`, new InlineStyle({ color: colorInputs[i % colorInputs.length], margin: `${i % 16}px` }));
+  }
+  const themeAccent = new InlineStyle({ color: "red", outline: "none" });
+  theme.set(".theme-accent", themeAccent);
+  const tokenSheet = new StyleSheet();
+  for (let i = 0; i < 10000; i++) {
+    tokenSheet.set(`.token-${i}`, new InlineStyle({ color: i % 100 === 0 ? "var(--brand)" : "red", margin: `${i % 16}px` }));
+  }
+  tokenSheet.defineToken("brand", new Color("#ff8800"));
+  const inlineCSS = "color: red; font-weight: bold; margin-left: 4px; display: flex; padding: 2px 4px";
+
+  const nullSink = new OutputSink({ target: { write() {} } });
+  const warner = new Warner({ level: "full", maxWarnings: 256, overflow: "keep-last", output: nullSink });
+  const warning = { message: "Deprecated option used", hint: "Use --strict instead.", tag: "bench" };
+  let warned = 0;
+
+  const argvProcess = (args) => ({ ...process, argv: [process.execPath, "cli", ...args] });
+  const cliArgs = ["build", "src", "--port", "8080", "-v", "--files", "a.ts", "b.ts", "--ratio=0.5", "--name", "app"];
+  const cli = new CLI(argvProcess(cliArgs), { warningLevel: "silent" });
+  const build = cli.command("build");
+  build.option("port", { type: "int", default: 80, alias: "p" });
+  build.option("verbose", { type: "bool", alias: "v" });
+  build.option("files", { type: "string[]" });
+  build.option("ratio", { type: "number" });
+  build.option("name");
+  build.on("command", () => {});
+
+  const cases = [
+    { module: "color", name: "new Color(hex)", fn: () => new Color("#ff8800") },
+    { module: "color", name: "new Color(rgba())", fn: () => new Color("rgba(255, 0, 128, 0.5)") },
+    { module: "color", name: "new Color(hsl())", fn: () => new Color("hsl(210, 50%, 40%)") },
+    { module: "color", name: "new Color(named)", fn: () => new Color("rebeccapurple") },
+    { module: "color", name: "Color#hex", fn: () => orange.hex() },
+    { module: "color", name: "Color#hsl", fn: () => orange.hsl() },
+    { module: "color", name: "Color.parseMany x1000", fn: () => Color.parseMany(colorBatch, colorOut, "unitrgba") },
+    { module: "color", name: "ColorBuffer#lighten x10000", fn: () => palette.lighten(0.2, paletteOut) },
+    { module: "color", name: "ColorBuffer#mix x10000", fn: () => palette.mix(paletteOut, 0.5, paletteOut) },
+    { module: "color", name: "ColorBuffer#contrast x10000", fn: () => palette.contrast(orange, contrastOut) },
+    { module: "jstc", name: "JSTC.for(3).check", fn: () => JSTC.for(narrowArgs).check(narrowTypes) },
+    { module: "jstc", name: "JSTC.for(32).check", fn: () => JSTC.for(wideArgs).check(wideTypes) },
+    { module: "jstc", name: "JSTC.checkAll 1000x8", fn: () => JSTC.checkAll(rows, rowSchema) },
+    {
+      module: "stylesheet",
+      name: "InlineStyle#generate (dirty)",
+      fn: () => {
+        style.addStyleWithObject({ color: (flip = !flip) ? "blue" : "red" });
+        return style.generate();
+      },
+    },
+    { module: "stylesheet", name: "InlineStyle#generate (cached)", fn: () => style.generate() },
+    { module: "stylesheet", name: "InlineStyle#ansi", fn: () => style.ansi },
+    { module: "stylesheet", name: "InlineStyle#addStyleWithInlineCSS", fn: () => style.addStyleWithInlineCSS(inlineCSS) },
+    { module: "stylesheet", name: "StyleSheet#generate x50", fn: () => sheet.generate() },
+    {
+      module: "stylesheet",
+      name: "StyleSheet#generate x10000 (1 changed)",
+      fn: () => {
+        themeAccent.addStyleWithObject({ color: (flip = !flip) ? "blue" : "red" });
+        return theme.generate();
+      },
+    },
+    { module: "stylesheet", name: "StyleSheet#rulesWith x10000", fn: () => theme.rulesWith("outline") },
+    {
+      module: "stylesheet",
+      name: "StyleSheet#defineToken + generate x10000",
+      fn: () => {
+        tokenSheet.defineToken("brand", (flip = !flip) ? "#123456" : "#654321");
+        return tokenSheet.generate();
+      },
+    },
+    { module: "stylesheet", name: "StyleSheet#generateBytes x10000", fn: () => theme.generateBytes() },
+    { module: "warner", name: "Warner#warn", fn: () => warner.warn(warning) },
+    {
+      module: "warner",
+      name: "Warner#warn x100 + flush",
+      fn: () => {
+        for (let i = 0; i < 100; i++) warner.warn(warning);
+        warner.flush();
+        if (++warned % 16 === 0) warner.clear();
+      },
+    },
+    { module: "cli-john", name: "CLI#run", fn: () => cli.run() },
+    { module: "cli-john", name: "Command#parse", fn: () => build.parse(cliArgs, 1) },
+  ];
+  return { natives, binary: nativeInfo(), cases: cases.filter((c) => `${c.module} ${c.name}`.includes(settings.filter)) };
+}
+//#endregion
+// -------------------------------------------------------------------------------------------------------
+//#region Measurement
+let sink;
+
+function timeBatch(fn, batch) {
+  const start = process.hrtime.bigint();
+  for (let i = 0; i < batch; i++) sink = fn();
+  return Number(process.hrtime.bigint() - start);
+}
+
+function percentile(sorted, p) {
+  const i = Math.min(sorted.length - 1, Math.max(0, Math.ceil((p / 100) * sorted.length) - 1));
+  return sorted[i];
+}
+
+function measure(fn) {
+  // Warm up for warmupMs so the JIT settles, then size batches to sampleMs.
+  const warmupEnd = performance.now() + settings.warmupMs;
+  let batch = 1;
+  do timeBatch(fn, batch);
+  while (performance.now() < warmupEnd);
+
+  const target = settings.sampleMs * 1e6;
+  for (let ns = timeBatch(fn, batch); ns < target && batch < 1e7; ns = timeBatch(fn, batch)) {
+    batch = ns <= 0 ? batch * 10 : Math.min(batch * 10, Math.ceil((batch * target) / ns));
+  }
+
+  const perOp = [];
+  for (let s = 0; s < settings.samples; s++) perOp.push(timeBatch(fn, batch) / batch);
+  perOp.sort((a, b) => a - b);
+  const mean = perOp.reduce((a, b) => a + b, 0) / perOp.length;
+  const round = (n) => Math.round(n * 100) / 100;
+  return {
+    batch,
+    samples: perOp.length,
+    meanNs: round(mean),
+    p50Ns: round(percentile(perOp, 50)),
+    p90Ns: round(percentile(perOp, 90)),
+    p99Ns: round(percentile(perOp, 99)),
+    opsPerSec: Math.round(1e9 / percentile(perOp, 50)),
+  };
+}
+
+async function runChild(mode) {
+  const { natives, binary, cases } = await loadCases();
+  const results = {};
+  for (const c of cases) results[`${c.module}: ${c.name}`] = { module: c.module, ...measure(c.fn) };
+  void sink;
+  process.stdout.write(JSON.stringify({ mode, natives, binary, results }));
+}
+//#endregion
+// -------------------------------------------------------------------------------------------------------
+//#region Orchestration
+function spawnMode(mode) {
+  const env = { ...process.env, BRIKLAB_WARNING_LEVEL: "silent" };
+  if (mode === "ts") env.BRIKLAB_NATIVE = "0";
+  else {
+    delete env.BRIKLAB_NATIVE;
+    env.BRIKLAB_JSTC_NATIVE_MIN_ARGS = "1";
+  }
+  const child = spawnSync(process.execPath, [fileURLToPath(import.meta.url), "--child", mode, ...argv], {
+    env,
+    encoding: "utf8",
+    maxBuffer: 64 * 1024 * 1024,
+    stdio: ["ignore", "pipe", "inherit"],
+  });
+  if (child.status !== 0) {
+    console.error(`[bench] ${mode} run failed with exit code ${child.status}.`);
+    process.exit(1);
+  }
+  return JSON.parse(child.stdout);
+}
+
+function compare(ts, nat) {
+  const cases = {};
+  const speedups = {};
+  for (const [name, t] of Object.entries(ts.results)) {
+    const n = nat.results[name];
+    const hasNative = nat.natives[t.module];
+    const speedup = hasNative && n ? Math.round((n.opsPerSec / t.opsPerSec) * 100) / 100 : null;
+    cases[name] = { module: t.module, ts: t, native: hasNative ? n : null, speedup };
+    if (speedup !== null) (speedups[t.module] ??= []).push(speedup);
+  }
+
+  // Geometric mean of a module's speedups; below 1 the addon costs more than it saves.
+  const modules = {};
+  for (const [module, available] of Object.entries(nat.natives)) {
+    const list = speedups[module] ?? [];
+    const geomean = list.length ? Math.exp(list.reduce((a, s) => a + Math.log(s), 0) / list.length) : null;
+    modules[module] = {
+      native: available,
+      speedup: geomean === null ? null : Math.round(geomean * 100) / 100,
+      worthIt: geomean === null ? null : geomean > 1,
+    };
+  }
+  return {
+    benchmark: "node-vs-ts",
+    node: process.version,
+    platform: `${process.platform}-${process.arch}`,
+    binary: nat.binary,
+    settings,
+    modules,
+    cases,
+  };
+}
+
+function checkBaseline(report, file, maxRegression) {
+  const baseline = JSON.parse(fs.readFileSync(file, "utf8"));
+  const regressions = [];
+  for (const [name, current] of Object.entries(report.cases)) {
+    const old = baseline.cases?.[name];
+    if (!old) continue;
+    for (const mode of ["ts", "native"]) {
+      if (!current[mode] || !old[mode]) continue;
+      const change = (current[mode].opsPerSec / old[mode].opsPerSec - 1) * 100;
+      if (change < -maxRegression) regressions.push({ case: name, mode, change: Math.round(change * 10) / 10 });
+    }
+  }
+  return regressions;
+}
+
+async function main() {
+  if (flag("--child")) return runChild(option("--child"));
+
+  const report = compare(spawnMode("ts"), spawnMode("native"));
+  const json = flag("--json");
+
+  if (!json) {
+    console.table(
+      Object.fromEntries(
+        Object.entries(report.cases).map(([name, c]) => [
+          name,
+          {
+            "ts ops/s": c.ts.opsPerSec,
+            "ts p99 ns": c.ts.p99Ns,
+            "native ops/s": c.native?.opsPerSec ?? "-",
+            "native p99 ns": c.native?.p99Ns ?? "-",
+            speedup: c.speedup ?? "-",
+          },
+        ]),
+      ),
+    );
+    for (const [module, m] of Object.entries(report.modules)) {
+      const verdict = !m.native ? "no addon" : m.speedup === null ? "no cases" : `${m.speedup}x ${m.worthIt ? "" : "(slower than TS)"}`;
+      console.log(`[bench] ${module}: ${verdict.trim()}`);
+    }
+    if (report.binary) console.log(`[bench] ${report.binary.file} (${report.binary.isa} kernels)`);
+  } else {
+    process.stdout.write(JSON.stringify(report, null, 2) + "\n");
+  }
+
+  const out = option("--out");
+  if (out) fs.writeFileSync(out, JSON.stringify(report, null, 2) + "\n");
+
+  const baseline = option("--baseline");
+  if (baseline) {
+    const regressions = checkBaseline(report, baseline, Number(option("--max-regression", 10)));
+    for (const r of regressions) console.error(`[bench] regression: ${r.case} (${r.mode}) ${r.change}%`);
+    if (regressions.length > 0) process.exit(1);
+  }
+}
+
+main().catch((error) => {
+  console.error(error);
+  process.exit(1);
+});
+//#endregion
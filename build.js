@@ -2,6 +2,7 @@ import { build } from "esbuild";
 import fs from "node:fs";
 import path from "node:path";
 import { spawnSync } from "node:child_process";
+import { pathToFileURL } from "node:url";
 
 const rootDir = process.cwd();
 const srcDir = path.join(rootDir, "src");
@@ -11,6 +12,8 @@ const args = new Set(process.argv.slice(2));
 const configureOnly = args.has("--configure-only");
 const nativeOnly = args.has("--native-only");
 const skipNative = args.has("--skip-native");
+const cleanNative = args.has("--clean");
+const prebuild = args.has("--prebuild");
 
 const shouldMinify = !configureOnly && !nativeOnly;
 const shouldNative = !skipNative;
@@ -29,32 +32,35 @@ function runCommand(command, commandArgs, cwd) {
   }
 }
 
-function findNativeSubmodules() {
-  if (!fs.existsSync(srcDir)) return [];
+// Every module's kernels are linked into one addon, built from src/native.
+const coreDir = path.join(srcDir, "native");
+const coreName = "briklab_core";
 
-  return fs
-    .readdirSync(srcDir, { withFileTypes: true })
-    .filter((entry) => entry.isDirectory())
-    .map((entry) => entry.name)
-    .filter((name) => fs.existsSync(path.join(srcDir, name, "node", "binding.gyp")));
-}
-
-function copyBuiltAddon(submodule) {
-  const nodeDir = path.join(srcDir, submodule, "node");
-  const releaseDir = path.join(nodeDir, "build", "Release");
-  if (!fs.existsSync(releaseDir)) return;
+// Prebuilds are collected from CI into prebuilds/<platform>-<arch>/ and
+// shipped in dist/native/prebuilds/, where src/native/load.ts looks for them.
+const prebuildsDir = path.join(rootDir, "prebuilds");
 
-  const files = fs.readdirSync(releaseDir).filter((f) => f.endsWith(".node"));
-  if (files.length === 0) return;
+function napiVersion() {
+  const gyp = fs.readFileSync(path.join(coreDir, "binding.gyp"), "utf8");
+  return Number(/NAPI_VERSION=(\d+)/.exec(gyp)?.[1] ?? 8);
+}
 
-  const preferred = files.find((f) => path.parse(f).name === submodule) ?? files[0];
-  const from = path.join(releaseDir, preferred);
-  const toDir = path.join(distDir, submodule, "native");
-  const to = path.join(toDir, `${submodule}.node`);
+function copyBuiltAddon() {
+  const from = path.join(coreDir, "build", "Release", `${coreName}.node`);
+  if (!fs.existsSync(from)) return;
 
-  fs.mkdirSync(toDir, { recursive: true });
+  const to = prebuild
+    ? path.join(prebuildsDir, `${process.platform}-${process.arch}`, `${coreName}.napi-v${napiVersion()}.node`)
+    : path.join(distDir, "native", `${coreName}.node`);
+  fs.mkdirSync(path.dirname(to), { recursive: true });
   fs.copyFileSync(from, to);
-  console.log(`[native] copied ${submodule} -> ${path.relative(rootDir, to)}`);
+  console.log(`[native] copied ${coreName} -> ${path.relative(rootDir, to)}`);
+}
+
+function copyPrebuilds() {
+  if (!fs.existsSync(prebuildsDir)) return;
+  fs.cpSync(prebuildsDir, path.join(distDir, "native", "prebuilds"), { recursive: true });
+  console.log("[native] copied prebuilds -> dist/native/prebuilds");
 }
 
 async function minifyDist() {
@@ -88,34 +94,55 @@ async function minifyDist() {
   }
 }
 
+// dist/cli-john/tags.js computes the default tag styles with InlineStyle on
+// first use; ship them as literals instead, from the same code path.
+async function precomputeTagStyles() {
+  const file = path.join(distDir, "cli-john", "tags.js");
+  if (!fs.existsSync(file)) return;
+  const { defaultTags } = await import(pathToFileURL(file).href);
+  const source =
+    "// Generated by build.js from src/cli-john/tags.ts.\n" +
+    `const presets = ${JSON.stringify(defaultTags(), null, 2)};\n` +
+    "export function defaultTags() {\n  return presets;\n}\n";
+  fs.writeFileSync(file, source);
+  console.log("[build] precomputed cli-john tag styles");
+}
+
+// Configure only when there is no build tree yet or binding.gyp changed;
+// node-gyp's make/msbuild step then only recompiles what changed.
+function needsConfigure() {
+  const config = path.join(coreDir, "build", "config.gypi");
+  if (!fs.existsSync(config)) return true;
+  return fs.statSync(path.join(coreDir, "binding.gyp")).mtimeMs > fs.statSync(config).mtimeMs;
+}
+
 function buildNativeAddons({ configureOnly: onlyConfigure }) {
-  const submodules = findNativeSubmodules();
-  if (submodules.length === 0) {
-    console.log("[native] no submodules with binding.gyp found");
+  if (!fs.existsSync(path.join(coreDir, "binding.gyp"))) {
+    console.log("[native] src/native/binding.gyp not found");
     return;
   }
 
-  for (const submodule of submodules) {
-    const nodeDir = path.join(srcDir, submodule, "node");
-    console.log(`[native] configuring ${submodule}`);
-    runCommand(nodeGypBin, ["configure"], nodeDir);
-
-    if (onlyConfigure) continue;
-
-    console.log(`[native] cleaning ${submodule}`);
-    runCommand(nodeGypBin, ["clean"], nodeDir);
-    console.log(`[native] re-configuring ${submodule}`);
-    runCommand(nodeGypBin, ["configure"], nodeDir);
-    console.log(`[native] building ${submodule}`);
-    runCommand(nodeGypBin, ["build"], nodeDir);
-    copyBuiltAddon(submodule);
+  if (cleanNative) {
+    console.log(`[native] cleaning ${coreName}`);
+    runCommand(nodeGypBin, ["clean"], coreDir);
+  }
+  if (onlyConfigure || cleanNative || needsConfigure()) {
+    console.log(`[native] configuring ${coreName}`);
+    runCommand(nodeGypBin, ["configure"], coreDir);
   }
+  if (onlyConfigure) return;
+
+  console.log(`[native] building ${coreName}`);
+  runCommand(nodeGypBin, ["build"], coreDir);
+  copyBuiltAddon();
 }
 
 (async () => {
   try {
     if (shouldMinify) {
+      await precomputeTagStyles();
       await minifyDist();
+      copyPrebuilds();
     }
 
     if (shouldNative) {
@@ -0,0 +1,201 @@
+/**
+ * Typed option parsing for CLI.Command.
+ *
+ * Recognized forms: `--name value`, `--name=value`, `--no-name` (bool),
+ * `-n value`, `-nvalue`, `-n=value`, `-abc` (bundled bool shorts) and `--`
+ * to stop.
+ * `string[]` options take every following value up to the next flag.
+ * A token is a flag when it starts with "-", is longer than one character
+ * and is not a number, so `--offset -5` works.
+ */
+
+export type OptionType = "string" | "number" | "int" | "bool" | "string[]";
+
+/**
+ * # Option Schema
+ * Declared with `command.option(name, schema)`.
+ */
+export interface OptionSchema {
+  /** Value type. Default: "string" */
+  type?: OptionType;
+  /** Used when the option is absent or its value is invalid */
+  default?: unknown;
+  /** Other names; one-character aliases are short flags (`-f`) */
+  alias?: string | string[];
+}
+
+/** Type codes stored in `ArgvSpec#types`. */
+export const OPTION_TYPE_CODES: Record<OptionType, number> = {
+  string: 0,
+  number: 1,
+  int: 2,
+  bool: 3,
+  "string[]": 4,
+};
+
+export const OPTION_TYPE_NAMES = Object.keys(OPTION_TYPE_CODES) as OptionType[];
+
+const TYPE_NUMBER = 1;
+const TYPE_INT = 2;
+const TYPE_BOOL = 3;
+const TYPE_LIST = 4;
+
+/** Error kinds reported in `tokenizeArgv` error triples. */
+export const ARGV_MISSING_VALUE = 1;
+export const ARGV_INVALID_VALUE = 2;
+
+/**
+ * Flattened option table of one command.
+ * `lookup` maps "--name" or "-n" to the option index; one-character names
+ * and aliases also get the short form.
+ */
+export interface ArgvSpec {
+  names: string[];
+  types: Uint8Array;
+  defaults: unknown[];
+  lookup: Map<string, number>;
+}
+
+const NUMERIC = /^[+-]?(?:\d+\.?\d*|\.\d+)(?:[eE][+-]?\d+)?$/;
+const TRUE_WORDS = new Set(["true", "1", "yes", "on"]);
+const FALSE_WORDS = new Set(["false", "0", "no", "off"]);
+const INVALID = Symbol("invalid");
+
+export function createArgvSpec(options: { name: string; schema: OptionSchema }[]): ArgvSpec {
+  const lookup = new Map<string, number>();
+  const add = (key: string, target: number) => {
+    if (!lookup.has(key)) lookup.set(key, target);
+  };
+
+  options.forEach(({ name, schema }, i) => {
+    add(`--${name}`, i);
+    if (name.length === 1) add(`-${name}`, i);
+    const aliases = schema.alias === undefined ? [] : ([] as string[]).concat(schema.alias);
+    for (const alias of aliases) add(alias.length === 1 ? `-${alias}` : `--${alias}`, i);
+  });
+
+  return {
+    names: options.map((o) => o.name),
+    types: Uint8Array.from(options, (o) => OPTION_TYPE_CODES[o.schema.type ?? "string"]),
+    defaults: options.map((o) => o.schema.default),
+    lookup,
+  };
+}
+
+export function isFlag(token: string): boolean {
+  return token.length > 1 && token.charCodeAt(0) === 45 /* - */ && !NUMERIC.test(token);
+}
+
+function convert(type: number, text: string): unknown {
+  switch (type) {
+    case TYPE_NUMBER:
+    case TYPE_INT: {
+      if (!NUMERIC.test(text)) return INVALID;
+      const n = Number(text);
+      if (!Number.isFinite(n) || (type === TYPE_INT && !Number.isInteger(n))) return INVALID;
+      return n;
+    }
+    case TYPE_BOOL: {
+      const word = text.toLowerCase();
+      if (TRUE_WORDS.has(word)) return true;
+      if (FALSE_WORDS.has(word)) return false;
+      return INVALID;
+    }
+    default:
+      return text;
+  }
+}
+
+/**
+ * Parse `argv` from index `start`. `values[i]` receives option i's value
+ * (undefined when absent) and `errors` receives
+ * `[option, tokenIndex, kind]` triples.
+ */
+export function tokenizeArgv(
+  argv: readonly string[],
+  start: number,
+  spec: ArgvSpec,
+  values: unknown[],
+  errors: number[],
+): void {
+  const { types, lookup } = spec;
+  values.length = types.length;
+  values.fill(undefined);
+
+  const assign = (option: number, inline: string | undefined, at: number): number => {
+    const type = types[option];
+    if (type === TYPE_LIST) {
+      const list = (values[option] as string[] | undefined) ?? (values[option] = []);
+      if (inline !== undefined) list.push(inline);
+      while (at + 1 < argv.length && !isFlag(argv[at + 1])) list.push(argv[++at]);
+      return at;
+    }
+    let text = inline;
+    if (text === undefined) {
+      if (type === TYPE_BOOL) {
+        values[option] = true;
+        return at;
+      }
+      if (at + 1 >= argv.length || isFlag(argv[at + 1])) {
+        errors.push(option, at, ARGV_MISSING_VALUE);
+        return at;
+      }
+      text = argv[++at];
+    }
+    const value = convert(type, text);
+    if (value === INVALID) errors.push(option, at, ARGV_INVALID_VALUE);
+    else values[option] = value;
+    return at;
+  };
+
+  for (let i = start; i < argv.length; i++) {
+    const token = argv[i];
+    if (token === "--") break;
+    if (!isFlag(token)) continue;
+
+    if (token.charCodeAt(1) === 45 /* - */) {
+      const eq = token.indexOf("=");
+      const key = eq < 0 ? token : token.slice(0, eq);
+      const option = lookup.get(key);
+      if (option !== undefined) {
+        i = assign(option, eq < 0 ? undefined : token.slice(eq + 1), i);
+      } else if (eq < 0 && key.startsWith("--no-")) {
+        const negated = lookup.get(`--${key.slice(5)}`);
+        if (negated !== undefined && types[negated] === TYPE_BOOL) values[negated] = false;
+      }
+      continue;
+    }
+
+    const option = lookup.get(token.slice(0, 2));
+    if (option === undefined) continue;
+    if (token.length === 2) {
+      i = assign(option, undefined, i);
+    } else if (types[option] !== TYPE_BOOL) {
+      i = assign(option, token.slice(token[2] === "=" ? 3 : 2), i);
+    } else {
+      // -abc: every character must be a bool short flag.
+      const bundle: number[] = [];
+      for (let c = 1; c < token.length; c++) {
+        const o = lookup.get(`-${token[c]}`);
+        if (o === undefined || types[o] !== TYPE_BOOL) break;
+        bundle.push(o);
+      }
+      if (bundle.length === token.length - 1) for (const o of bundle) values[o] = true;
+    }
+  }
+}
+
+/**
+ * Typed values by option name: parsed values, then defaults; bool options
+ * default to false and string[] options to [].
+ */
+export function optionValues(spec: ArgvSpec, values: readonly unknown[]): Record<string, unknown> {
+  const out: Record<string, unknown> = {};
+  for (let i = 0; i < spec.names.length; i++) {
+    let value = values[i] ?? spec.defaults[i];
+    if (value === undefined && spec.types[i] === TYPE_BOOL) value = false;
+    if (value === undefined && spec.types[i] === TYPE_LIST) value = [];
+    if (value !== undefined) out[spec.names[i]] = value;
+  }
+  return out;
+}
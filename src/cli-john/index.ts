@@ -58,11 +58,24 @@
 import JSTC, { type ProtectionLevel } from "../jstc/index.js";
 import InlineStyle, { StyleSheet } from "../stylesheet/index.js";
 import Color from "../color/index.js";
-import { createWarner } from "../warner/index.js";
+import { createWarner, getOutputSink, type OutputSink } from "../warner/index.js";
 import { loadNativeAddon } from "../native/load.js";
+import {
+  ARGV_MISSING_VALUE,
+  OPTION_TYPE_NAMES,
+  createArgvSpec,
+  optionValues,
+  tokenizeArgv,
+  type ArgvSpec,
+  type OptionSchema,
+} from "./argv.js";
+import { WorkerPool, workerSource } from "./pool.js";
+import { defaultTags, type TagPreset } from "./tags.js";
+
+export type { OptionSchema, OptionType } from "./argv.js";
 
 const cliWarner = createWarner("@briklab/lib/cli-john");
-export const native = loadNativeAddon(import.meta.url, "cli-john");
+export const native = loadNativeAddon("cli-john");
 
 function formatCLIMessage(
   scope: string,
@@ -78,6 +91,12 @@ function formatCLIMessage(
     .filter((line): line is string => Boolean(line))
     .join("\n");
 }
+
+/** Warn through cliWarner without formatting up front. */
+function warnCLI(scope: string, message: string, hint?: string, otherMessage?: string): void {
+  if (!cliWarner.enabled) return;
+  cliWarner.warn({ scope, message, hint, otherMessage });
+}
 JSTC.addCustomHandler("NodeJS Process", (p: any) => {
   return (
     p &&
@@ -87,6 +106,27 @@ JSTC.addCustomHandler("NodeJS Process", (p: any) => {
     typeof p.exit === "function"
   );
 });
+const isNodeProcess = JSTC.compile(["NodeJS Process"]);
+const isString = JSTC.compile(["string"]);
+const isEventAndHandler = JSTC.compile(["string", "function"]);
+const isNameAndObject = JSTC.compile(["string", "object"]);
+
+/** Handlers registered with `{ worker: true }`; they return a promise. */
+const workerHandlers = new WeakSet<Function>();
+let workerPool: WorkerPool | null = null;
+let workerPoolSize: number | undefined;
+
+/** Worker output joins the shared buffered sink (or Utilities' own one). */
+function writeWorkerOutput(text: string) {
+  (Utilities.output ?? getOutputSink()).write(text.endsWith("\n") ? text.slice(0, -1) : text);
+}
+
+function toWorkerHandler(source: string): Function {
+  const handler = (payload: unknown) =>
+    (workerPool ??= new WorkerPool(writeWorkerOutput, workerPoolSize)).run(source, payload);
+  workerHandlers.add(handler);
+  return handler;
+}
 //#endregion
 // -------------------------------------------------------------------------------------------------------
 //#region The Main Class
@@ -106,6 +146,7 @@ export class CLI {
    * @param {Object} options - Optional configuration
    * @param {WarningLevel} options.warningLevel - Warning display level: 'silent', 'summary', or 'full'
    * @param {ProtectionLevel} options.protectionLevel - Protection level for input validation
+   * @param {number} options.workers - Worker threads for `{ worker: true }` handlers (default: cores - 1)
    * @constructor
    * @constructs CLI
    * @example
@@ -119,9 +160,10 @@ export class CLI {
     options?: {
       warningLevel?: "silent" | "summary" | "full";
       protectionLevel?: ProtectionLevel;
+      workers?: number;
     },
   ) {
-    if (!JSTC.for([process]).check(["NodeJS Process"])) {
+    if (!isNodeProcess(process)) {
       throw this.#createErr(
         "Invalid first argument.",
         "You must pass a valid NodeJS process (imported from node:process) while constructing a CLI Class!",
@@ -136,9 +178,19 @@ export class CLI {
       JSTC.setProtectionLevel(options.protectionLevel);
       cliWarner.setProtectionLevel(options.protectionLevel);
     }
+    if (options?.workers !== undefined) {
+      if (Number.isInteger(options.workers) && options.workers > 0) workerPoolSize = options.workers;
+      else
+        this.#createWarn(
+          "Invalid workers option.",
+          "options.workers must be a positive integer.",
+          "Using the number of cores - 1.",
+        );
+    }
   }
   #protectionLevel: ProtectionLevel = "boundary";
-  #commands: CLI.Command[] = [];
+  /** Commands by name; replacing a command keeps its registration order. */
+  #commands = new Map<string, CLI.Command>();
   /**
    * ### CLI.command
    * create a new command in a CLI.
@@ -146,7 +198,7 @@ export class CLI {
    * @param {string} name
    */
   command(name: string) {
-    if (!JSTC.for([name]).check(["string"])) {
+    if (!isString(name)) {
       this.#createWarn(
         "Invalid first argument.",
         "CLI.command expects a string as the first argument.",
@@ -163,9 +215,7 @@ export class CLI {
       name = name.replace(" ", "");
     }
     let c = new CLI.Command(name, this.command.bind(this));
-    let f = this.#commands.findIndex((a) => a.name === name);
-    if (f !== -1) this.#commands[f] = c;
-    else this.#commands.push(c);
+    this.#commands.set(name, c);
     return c;
   }
   #onCmdFunctions: Function[] = [];
@@ -179,9 +229,10 @@ export class CLI {
       commandArgs: string[];
       command: string;
       options: { arguments: string[]; optionName: string }[];
+      values: Record<string, unknown>;
     }) => any,
   ) {
-    if (!JSTC.for([event, func]).check(["string", "function"]))
+    if (!isEventAndHandler(event, func))
       throw this.#createErr(
         "Invalid arguments in CLI.on.",
         "The first argument must be a string, and the second argument must be a function.",
@@ -197,62 +248,97 @@ export class CLI {
         );
     }
   }
+  /**
+   * Run the handlers of the command in `process.argv`. Returned promises are
+   * not awaited and worker handlers are only started; use `runAsync` to
+   * wait for them.
+   */
   run() {
-    let { options, commandArgs, commandName, commandMetadata, failed } =
+    let { options, commandArgs, commandName, commandMetadata, values, failed } =
       this.#figureOutCommand();
     if (failed) return;
     for (let i = 0; i < this.#onCmdFunctions.length; i++) {
-      this.#onCmdFunctions[i]({ options, commandArgs, command: commandName });
+      this.#onCmdFunctions[i]({ options, commandArgs, command: commandName, values });
     }
     const onCmdFunctions = (commandMetadata as any)?.onCmdFunctions ?? [];
     for (let i = 0; i < onCmdFunctions.length; i++) {
-      onCmdFunctions[i]({ options, commandArgs });
+      const result = onCmdFunctions[i]({ options, commandArgs, values });
+      if (workerHandlers.has(onCmdFunctions[i])) {
+        result.catch((e: unknown) => this.#workerFailed(e));
+      }
     }
 
     cliWarner.flush();
   }
+  /**
+   * Like `run`, but awaits every handler in registration order. Consecutive
+   * worker handlers run in parallel and are awaited together before the next
+   * main-thread handler starts. Rejects with the first handler error.
+   * @example
+   * await cli.runAsync();
+   */
+  async runAsync(): Promise<void> {
+    let { options, commandArgs, commandName, commandMetadata, values, failed } =
+      this.#figureOutCommand();
+    if (failed) return;
+    try {
+      for (let i = 0; i < this.#onCmdFunctions.length; i++) {
+        await this.#onCmdFunctions[i]({ options, commandArgs, command: commandName, values });
+      }
+      const onCmdFunctions: Function[] = (commandMetadata as any)?.onCmdFunctions ?? [];
+      let running: Promise<void>[] = [];
+      for (const func of onCmdFunctions) {
+        if (workerHandlers.has(func)) {
+          running.push(func({ options, commandArgs, values }));
+          continue;
+        }
+        await Promise.all(running);
+        running = [];
+        await func({ options, commandArgs, values });
+      }
+      await Promise.all(running);
+    } finally {
+      Utilities.flush();
+      cliWarner.flush();
+    }
+  }
+  #workerFailed(error: unknown) {
+    this.#createWarn(
+      "A worker handler failed.",
+      "Use cli.runAsync() to await worker handlers and catch their errors.",
+      String((error as Error)?.stack ?? error),
+    );
+  }
   #figureOutCommand() {
-    // for eg. we have nodepath filepath cli build
-    let [, , ...commands] = this.#process.argv; // now its cli build. clear
-    if (commands.length === 0)
-      return {
-        options: [],
-        commandName: "",
-        commandMetadata: null,
-        commandArgs: [],
-        failed: true,
-      };
-    const command = this.#commands.find((a) => a.name === commands[0]); // find the command
+    // for eg. we have nodepath filepath cli build --force a b
+    const argv = this.#process.argv;
+    const command = argv.length > 2 ? this.#commands.get(argv[2]) : undefined;
     if (!command)
       return {
         options: [],
         commandName: "",
         commandMetadata: null,
         commandArgs: [],
+        values: {},
         failed: true,
-      }; // command not found?
-    const commandName = commands[0];
-    let commandArgs: string[] = [];
-    const args = commands.slice(1);
-    for (let i: number = 0; i < args.length; i++) {
-      let arg = args[i];
-      if (arg.startsWith("--")) break;
-      commandArgs.push(arg);
-    }
-    let leftover = args.slice(commandArgs.length); // args = [1,2,3]; command args = [1,2] command args length is 2, therefore .slice(2) results in [3]
-    let options: { option: string; arguments: string[] }[] = [];
-
-    for (let i = 0; i < leftover.length; i++) {
-      const opt = leftover[i];
-      if (!opt.startsWith("--")) continue;
-
-      const values = [];
-      for (let j = i + 1; j < leftover.length; j++) {
-        if (leftover[j].startsWith("--")) break;
-        values.push(leftover[j]);
+      }; // no command given, or command not found
+    const commandName = argv[2];
+
+    // One pass: values before the first --flag are command args, later values
+    // belong to the closest preceding --flag.
+    const commandArgs: string[] = [];
+    const options: { option: string; arguments: string[] }[] = [];
+    let current: string[] | null = null;
+    for (let i = 3; i < argv.length; i++) {
+      const arg = argv[i];
+      if (arg.startsWith("--")) {
+        current = [];
+        options.push({ option: arg, arguments: current });
+      } else if (current) {
+        current.push(arg);
+      } else {
+        commandArgs.push(arg);
       }
-
-      options.push({ option: opt, arguments: values });
     }
 
     return {
@@ -260,6 +346,7 @@ export class CLI {
       commandName,
       commandMetadata: command.metadata(),
       commandArgs,
+      values: command.parse(argv, 3),
       failed: false,
     };
   }
@@ -274,9 +361,7 @@ export class CLI {
     return new this.#ErrorClass(formatCLIMessage("Class CLI", message, hint, otherMessage));
   }
   #createWarn(message: string, hint: string, otherMessage?: string) {
-    cliWarner.warn({
-      message: formatCLIMessage("Class CLI", message, hint, otherMessage),
-    });
+    warnCLI("Class CLI", message, hint, otherMessage);
     return;
   }
 }
@@ -332,7 +417,17 @@ export namespace CLI {
     }
     #onCmdFunctions: Function[] = [];
     /**
-     * What to do when an specific event happens
+     * What to do when an specific event happens.
+     *
+     * With `{ worker: true }` the handler runs in a pooled worker thread. It
+     * is rebuilt there from its source, so it cannot use variables from
+     * the surrounding scope: load modules with `await import(...)` inside it.
+     * `Utilities` is available and its output is forwarded to this thread.
+     * @example
+     * cmd.on("command", async ({ values }) => {
+     *   const { default: Color } = await import("@briklab/lib/color");
+     *   Utilities.info(new Color(String(values.color)).hex());
+     * }, { worker: true });
      */
     on(
       event: CLI.ValidEvent,
@@ -342,16 +437,18 @@ export namespace CLI {
       }: {
         commandArgs: string[];
         options: { arguments: string[]; optionName: string }[];
+        values: Record<string, unknown>;
       }) => any,
+      handlerOptions?: { worker?: boolean },
     ) {
-      if (!JSTC.for([event, func]).check(["string", "function"]))
+      if (!isEventAndHandler(event, func))
         throw this.#createErr(
           "Invalid arguments in CLI.Command.on.",
           "The first argument must be a string, and the second argument must be a function.",
         );
       switch (event.toLowerCase()) {
         case "command":
-          this.#onCmdFunctions.push(func);
+          this.#onCmdFunctions.push(handlerOptions?.worker ? this.#workerHandler(func) : func);
           break;
         default:
           this.#createWarn(
@@ -360,13 +457,23 @@ export namespace CLI {
           );
       }
     }
+    #workerHandler(func: Function): Function {
+      const source = WorkerPool.supported ? workerSource(func) : undefined;
+      if (source === undefined) {
+        this.#createWarn(
+          "The handler cannot run in a worker.",
+          "Worker handlers must be plain function or arrow function expressions in Node.js, not bound or native functions or method shorthands.",
+          "Running it on the main thread.",
+        );
+        return func;
+      }
+      return toWorkerHandler(source);
+    }
     #createWarn(message: string, hint: string, otherMessage?: string) {
-      cliWarner.warn({
-        message: formatCLIMessage("Class CLI.Command", message, hint, otherMessage),
-      });
+      warnCLI("Class CLI.Command", message, hint, otherMessage);
       return;
     }
-    #options: CLI.Command.Option[] = [];
+    #options = new Map<string, CLI.Command.Option>();
     /**
      * The name of the Command
      * @returns {string}
@@ -380,14 +487,20 @@ export namespace CLI {
      */
     metadata(): Object {
       let meta = {
-        options: this.#options.map((a) => a.metadata),
+        options: Array.from(this.#options.values(), (a) => a.metadata),
         name: `${this.name}`,
         onCmdFunctions: [...this.#onCmdFunctions],
       };
       return meta;
     }
-    option(name: string) {
-      if (!JSTC.for([name]).check(["string"])) {
+    /**
+     * Add an option. With a schema, `parse` (and the `values` passed to
+     * command handlers) converts it to its declared type.
+     * @example
+     * cmd.option("port", { type: "int", default: 8080, alias: "p" });
+     */
+    option(name: string, schema?: OptionSchema) {
+      if (!isString(name)) {
         this.#createWarn(
           "Invalid first argument.",
           "The first argument in CLI.command.option must be a string",
@@ -403,17 +516,72 @@ export namespace CLI {
         );
         name = name.replace(" ", "");
       }
+      if (schema !== undefined && (typeof schema !== "object" || schema === null)) {
+        this.#createWarn(
+          "Invalid option schema.",
+          "The second argument in CLI.command.option must be an object like { type: \"number\" }.",
+          "Ignoring the schema.",
+        );
+        schema = undefined;
+      }
+      if (schema?.type !== undefined && !OPTION_TYPE_NAMES.includes(schema.type)) {
+        this.#createWarn(
+          `Unknown option type "${schema.type}".`,
+          'Use "string", "number", "int", "bool" or "string[]".',
+          'Using "string" as fallback.',
+        );
+        schema = { ...schema, type: "string" };
+      }
       let o = new CLI.Command.Option(
         name,
         this.option.bind(this),
         this.#commandcreatorfunction,
+        schema,
       );
-      let f = this.#options.findIndex((a) => a.name === name);
-      if (f !== -1) this.#options[f] = o;
-      else this.#options.push(o);
+      this.#options.set(name, o);
+      this.#spec = null;
       return o;
     }
 
+    /** Option table for `parse`, rebuilt after options change. */
+    #spec: ArgvSpec | null = null;
+
+    /**
+     * Typed values of this command's options in `argv`, starting at `start`.
+     * Invalid or missing values are warned about and replaced by the default.
+     * @example
+     * cmd.parse(["--port", "80", "-v"]); // { port: 80, verbose: true }
+     */
+    parse(argv: readonly string[], start = 0): Record<string, unknown> {
+      if (!Array.isArray(argv)) {
+        this.#createWarn(
+          "Invalid first argument.",
+          "CLI.Command.parse expects an array of strings.",
+          "Using [] as fallback.",
+        );
+        argv = [];
+      }
+      const spec = (this.#spec ??= createArgvSpec(
+        Array.from(this.#options.values(), (o) => ({ name: o.name.replace(/^-+/, ""), schema: o.schema })),
+      ));
+
+      const values: unknown[] = [];
+      const errors: number[] = [];
+      tokenizeArgv(argv, start, spec, values, errors);
+
+      for (let e = 0; e < errors.length; e += 3) {
+        const name = spec.names[errors[e]];
+        this.#createWarn(
+          errors[e + 2] === ARGV_MISSING_VALUE
+            ? `Missing value for option "--${name}".`
+            : `Invalid value ${JSON.stringify(argv[errors[e + 1]])} for option "--${name}".`,
+          `Option "--${name}" expects a value of type "${OPTION_TYPE_NAMES[spec.types[errors[e]]]}".`,
+          "Using the default value.",
+        );
+      }
+      return optionValues(spec, values);
+    }
+
     command(...args: any[]) {
       this.#commandcreatorfunction(...args);
     }
@@ -432,15 +600,18 @@ export namespace CLI.Command {
     #optioncreatorfunction: Function;
     #commandcreatorfunction: Function;
     #onCmdFunctions: Function[] = [];
+    #schema: OptionSchema;
 
     constructor(
       name: string,
       optioncreatorfunc: Function,
       commandcreatorfunction: Function,
+      schema: OptionSchema = {},
     ) {
       this.#name = name;
       this.#optioncreatorfunction = optioncreatorfunc;
       this.#commandcreatorfunction = commandcreatorfunction;
+      this.#schema = { ...schema };
       return this;
     }
 
@@ -448,6 +619,11 @@ export namespace CLI.Command {
       return this.#name;
     }
 
+    /** Declared type, default and aliases of this option. */
+    get schema(): OptionSchema {
+      return { ...this.#schema };
+    }
+
     get metadata() {
       let metadata = {
         name: `${this.#name}`,
@@ -467,9 +643,10 @@ export namespace CLI.Command {
       }: {
         commandArgs: string[];
         options: { arguments: string[]; optionName: string }[];
+        values: Record<string, unknown>;
       }) => any,
     ) {
-      if (!JSTC.for([event, func]).check(["string", "function"]))
+      if (!isEventAndHandler(event, func))
         throw this.#createErr(
           "Invalid arguments in CLI.Command.Option.on.",
           "The first argument must be a string, and the second argument must be a function.",
@@ -500,9 +677,7 @@ export namespace CLI.Command {
     }
 
     #createWarn(message: string, hint: string, otherMessage?: string) {
-      cliWarner.warn({
-        message: formatCLIMessage("Class CLI.Command.Option", message, hint, otherMessage),
-      });
+      warnCLI("Class CLI.Command.Option", message, hint, otherMessage);
       return;
     }
 
@@ -529,63 +704,71 @@ JSTC.addCustomHandler("Utilities Tag Config", (p: any) => {
     (typeof p.styleName === "string" || p.styleName === undefined)
   );
 });
+const isTagConfig = JSTC.compile(["Utilities Tag Config"]);
+
+type TagConfig = {
+  tag: string;
+  showErrorInTag: boolean;
+  paddingLeft: number;
+  paddingRight: number;
+  styleName: string;
+};
+
+const tagStyleName = (tagName: string) => `${tagName} Tag Color`;
+
+/** Default tag presets by style name, built on first use. */
+let defaultTagStyles: Map<string, TagPreset> | null = null;
+const defaultTagStyle = (styleName: string) =>
+  (defaultTagStyles ??= new Map(
+    Object.entries(defaultTags()).map(([name, preset]) => [tagStyleName(name), preset]),
+  )).get(styleName);
 
 class UtilitiesClass {
-  styleSheet = new StyleSheet();
-
-  tags: Record<
-    string,
-    {
-      tag: string;
-      showErrorInTag: boolean;
-      paddingLeft: number;
-      paddingRight: number;
-      styleName: string;
-    }
-  > = {};
-
-  constructor() {
-    this.addTag("error", {
-      tag: "ERROR",
-      showErrorInTag: false,
-      paddingLeft: 0,
-      paddingRight: 0,
-    });
-    this.addTag("warning", {
-      tag: "WARNING",
-      showErrorInTag: true,
-      paddingLeft: 0,
-      paddingRight: 0,
-    });
-    this.addTag("info", {
-      tag: "INFO",
-      showErrorInTag: true,
-      paddingLeft: 0,
-      paddingRight: 0,
-    });
+  #styleSheet: StyleSheet | null = null;
+  #tags: Record<string, TagConfig> | null = null;
+  #output: OutputSink | null = null;
 
-    this.setTagStyle(
-      "error",
-      new InlineStyle({ color: "red", fontWeight: "bold" }),
-    );
-    this.setTagStyle(
-      "warning",
-      new InlineStyle({ color: "orange", fontWeight: "bold" }),
-    );
-    this.setTagStyle("info", new InlineStyle({ color: "blue" }));
+  /**
+   * Style rules of the tags. Created with the default tag styles on first
+   * access.
+   */
+  get styleSheet(): StyleSheet {
+    if (this.#styleSheet === null) {
+      this.#styleSheet = new StyleSheet();
+      for (const [name, preset] of Object.entries(defaultTags())) {
+        this.#styleSheet.set(tagStyleName(name), new InlineStyle({ ...preset.style }));
+      }
+    }
+    return this.#styleSheet;
+  }
+
+  set styleSheet(styleSheet: StyleSheet) {
+    this.#styleSheet = styleSheet;
+  }
+
+  get tags(): Record<string, TagConfig> {
+    if (this.#tags === null) {
+      this.#tags = {};
+      for (const [name, preset] of Object.entries(defaultTags())) {
+        this.#tags[name] = { ...preset.config, styleName: tagStyleName(name) };
+      }
+    }
+    return this.#tags;
+  }
+
+  set tags(tags: Record<string, TagConfig>) {
+    this.#tags = tags;
   }
 
   /** Add a new tag */
-  addTag(name: string, config: Partial<(typeof this.tags)["error"]> = {}) {
-    if (!JSTC.for([name, config]).check(["string", "object"])) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.addTag",
-          "Invalid arguments.",
-          "The first argument must be a string and the second argument must be an object.",
-          "Using JSON.stringify(argument1) and {} as fallback.",
-        ),
-      });
+  addTag(name: string, config: Partial<TagConfig> = {}) {
+    if (!isNameAndObject(name, config)) {
+      warnCLI(
+        "UtilitiesClass.addTag",
+        "Invalid arguments.",
+        "The first argument must be a string and the second argument must be an object.",
+        "Using JSON.stringify(argument1) and {} as fallback.",
+      );
       name = JSON.stringify(name);
       config = {};
     }
@@ -598,15 +781,13 @@ class UtilitiesClass {
       ...config,
     };
 
-    if (!JSTC.for([fullConfig]).check(["Utilities Tag Config"])) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.addTag",
-          `Invalid tag config for "${name}".`,
-          "The config must match {tag?: string, showErrorInTag?: boolean, paddingLeft?: number, paddingRight?: number, styleName?: string}.",
-          JSON.stringify(fullConfig, null, 2),
-        ),
-      });
+    if (!isTagConfig(fullConfig)) {
+      warnCLI(
+        "UtilitiesClass.addTag",
+        `Invalid tag config for "${name}".`,
+        "The config must match {tag?: string, showErrorInTag?: boolean, paddingLeft?: number, paddingRight?: number, styleName?: string}.",
+        JSON.stringify(fullConfig, null, 2),
+      );
       return this;
     }
 
@@ -617,43 +798,62 @@ class UtilitiesClass {
   /** Set style for a tag */
   setTagStyle(tagName: string, style: InlineStyle) {
     if (typeof tagName !== "string" || !(style instanceof InlineStyle)) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.setTagStyle",
-          "Invalid arguments.",
-          "The first argument must be a string and the second argument must be an InlineStyle instance.",
-          "Using JSON.stringify(firstArgument) and new InlineStyle({}) as fallback.",
-        ),
-      });
+      warnCLI(
+        "UtilitiesClass.setTagStyle",
+        "Invalid arguments.",
+        "The first argument must be a string and the second argument must be an InlineStyle instance.",
+        "Using JSON.stringify(firstArgument) and new InlineStyle({}) as fallback.",
+      );
       tagName = JSON.stringify(tagName);
       style = new InlineStyle({});
     }
     if (!this.tags[tagName]) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.setTagStyle",
-          `Tag "${tagName}" does not exist.`,
-          'Use a defined tag or one of "error"|"warn"|"info".',
-        ),
-      });
+      warnCLI(
+        "UtilitiesClass.setTagStyle",
+        `Tag "${tagName}" does not exist.`,
+        'Use a defined tag or one of "error"|"warn"|"info".',
+      );
       return this;
     }
-    const styleName = `${tagName} Tag Color`;
+    const styleName = tagStyleName(tagName);
     this.styleSheet.set(styleName, style);
     this.tags[tagName].styleName = styleName;
     return this;
   }
 
+  /**
+   * Route `log` output through a buffered sink (e.g. `getOutputSink()`),
+   * or back to `console.log` with `null`.
+   */
+  setOutput(sink: OutputSink | null) {
+    this.#output = sink;
+    return this;
+  }
+
+  /** The sink set with `setOutput`, if any. */
+  get output(): OutputSink | null {
+    return this.#output;
+  }
+
+  /** Write out anything buffered in the output sink. */
+  flush() {
+    this.#output?.flush();
+    return this;
+  }
+
+  #print(...args: any[]) {
+    if (this.#output) this.#output.log(...args);
+    else console.log(...args);
+  }
+
   log(tagName: string, ...messages: any[]) {
-    if (!JSTC.for([tagName]).check(["string"])) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.log",
-          "Invalid arguments.",
-          "The first argument must be a string.",
-          "Using JSON.stringify(argument1) as fallback.",
-        ),
-      });
+    if (!isString(tagName)) {
+      warnCLI(
+        "UtilitiesClass.log",
+        "Invalid arguments.",
+        "The first argument must be a string.",
+        "Using JSON.stringify(argument1) as fallback.",
+      );
       tagName = JSON.stringify(tagName);
     }
 
@@ -661,19 +861,18 @@ class UtilitiesClass {
 
     const tag = this.tags[tagName];
     if (!tag) {
-      cliWarner.warn({
-        message: formatCLIMessage(
-          "UtilitiesClass.log",
-          `Tag "${tagName}" does not exist.`,
-          'Use a defined tag or one of "error"|"warn"|"info".',
-        ),
-      });
-      console.log(...messages);
+      warnCLI(
+        "UtilitiesClass.log",
+        `Tag "${tagName}" does not exist.`,
+        'Use a defined tag or one of "error"|"warn"|"info".',
+      );
+      this.#print(...messages);
       return;
     }
 
-    const inlineStyle = this.styleSheet.get(tag.styleName);
-    const style = inlineStyle?.text ?? "";
+    // Until the stylesheet exists it only holds the defaults, so use their presets.
+    const preset = this.#styleSheet === null ? defaultTagStyle(tag.styleName) : undefined;
+    const inlineStyle = preset ? undefined : this.#styleSheet?.get(tag.styleName);
     const leftPad = " ".repeat(tag.paddingLeft);
     const rightPad = " ".repeat(tag.paddingRight);
 
@@ -683,29 +882,30 @@ class UtilitiesClass {
       Boolean((process.stdout as any).isTTY);
 
     if (isNodeTTY) {
-      const ansi = inlineStyle?.ansi ?? "";
+      const ansi = preset ? preset.ansi : (inlineStyle?.ansi ?? "");
       const reset = Color.RESET;
 
       if (tag.showErrorInTag) {
-        console.log(
+        this.#print(
           "[" + ansi + leftPad + tag.tag + rightPad + reset + "]:",
           ...messages,
         );
       } else {
-        console.log(
+        this.#print(
           ansi + "[" + leftPad + tag.tag + rightPad + "]" + reset + ":",
           ...messages,
         );
       }
     } else {
+      const style = preset ? preset.css : (inlineStyle?.text ?? "");
       if (tag.showErrorInTag) {
-        console.log(
+        this.#print(
           `[%c${leftPad}${tag.tag}${rightPad}%c]:`,
           style,
           ...messages,
         );
       } else {
-        console.log(
+        this.#print(
           `%c[${leftPad}${tag.tag}${rightPad}]%c:`,
           style,
           ...messages,
@@ -0,0 +1,142 @@
+/**
+ * Worker-thread pool behind `command.on("command", fn, { worker: true })`.
+ *
+ * Handlers are shipped as source text and compiled once per worker (see
+ * ./worker.ts), so they must be self-contained: no captured variables, and
+ * modules are loaded with `await import(...)` inside the handler.
+ * `Utilities` is in scope; its log output is batched per tick in the worker
+ * and handed to `onOutput` on the main thread before the task settles.
+ */
+
+type WorkerThreads = typeof import("node:worker_threads");
+type Worker = import("node:worker_threads").Worker;
+
+/** Messages posted by ./worker.ts. */
+export type WorkerReply =
+  | { type: "output"; text: string }
+  | { type: "done"; id: number }
+  | { type: "error"; id: number; error: unknown };
+
+/** Message posted to ./worker.ts. */
+export interface WorkerTask {
+  id: number;
+  source: string;
+  payload: unknown;
+}
+
+interface PendingTask extends WorkerTask {
+  resolve(): void;
+  reject(error: unknown): void;
+}
+
+let workerThreads: WorkerThreads | null | undefined;
+
+function getWorkerThreads(): WorkerThreads | null {
+  if (workerThreads === undefined) {
+    const getBuiltin = globalThis.process?.getBuiltinModule;
+    workerThreads =
+      typeof getBuiltin === "function" ? (getBuiltin("node:worker_threads") as WorkerThreads) : null;
+  }
+  return workerThreads;
+}
+
+function defaultPoolSize(): number {
+  const os = globalThis.process?.getBuiltinModule?.("node:os") as typeof import("node:os") | undefined;
+  const cores = os?.availableParallelism?.() ?? os?.cpus().length ?? 2;
+  return Math.max(1, cores - 1);
+}
+
+/**
+ * Check that `func` can be rebuilt from its source in a worker.
+ * Returns the source, or undefined for native, bound or method-shorthand
+ * functions.
+ */
+export function workerSource(func: Function): string | undefined {
+  const source = Function.prototype.toString.call(func);
+  if (source.endsWith("{ [native code] }")) return undefined;
+  try {
+    new Function("Utilities", `return (${source});`);
+  } catch {
+    return undefined;
+  }
+  return source;
+}
+
+export class WorkerPool {
+  #size: number;
+  #onOutput: (text: string) => void;
+  #idle: Worker[] = [];
+  #busy = new Map<Worker, PendingTask>();
+  #queue: PendingTask[] = [];
+  #nextId = 0;
+
+  constructor(onOutput: (text: string) => void, size = defaultPoolSize()) {
+    this.#onOutput = onOutput;
+    this.#size = size;
+  }
+
+  /** Whether this runtime has worker_threads. */
+  static get supported(): boolean {
+    return getWorkerThreads() !== null;
+  }
+
+  /** Run `source` (see `workerSource`) on `payload` in a pooled worker. */
+  run(source: string, payload: unknown): Promise<void> {
+    return new Promise((resolve, reject) => {
+      this.#queue.push({ id: this.#nextId++, source, payload, resolve, reject });
+      this.#drain();
+    });
+  }
+
+  /** Stop every worker; queued and running tasks are rejected. */
+  async close() {
+    const error = new Error("Worker pool closed.");
+    for (const task of this.#queue.splice(0)) task.reject(error);
+    const workers = [...this.#idle, ...this.#busy.keys()];
+    for (const task of this.#busy.values()) task.reject(error);
+    this.#idle = [];
+    this.#busy.clear();
+    await Promise.all(workers.map((w) => w.terminate()));
+  }
+
+  #drain() {
+    while (this.#queue.length > 0) {
+      const worker = this.#idle.pop() ?? (this.#busy.size < this.#size ? this.#spawn() : undefined);
+      if (!worker) return;
+      const task = this.#queue.shift()!;
+      this.#busy.set(worker, task);
+      worker.ref();
+      worker.postMessage({ id: task.id, source: task.source, payload: task.payload } as WorkerTask);
+    }
+  }
+
+  #spawn(): Worker {
+    const { Worker } = getWorkerThreads()!;
+    const worker = new Worker(new URL("./worker.js", import.meta.url));
+    worker.on("message", (reply: WorkerReply) => {
+      if (reply.type === "output") {
+        this.#onOutput(reply.text);
+        return;
+      }
+      const task = this.#busy.get(worker);
+      if (!task || task.id !== reply.id) return;
+      this.#busy.delete(worker);
+      if (reply.type === "done") task.resolve();
+      else task.reject(reply.error);
+      // Idle workers must not keep the process alive.
+      worker.unref();
+      this.#idle.push(worker);
+      this.#drain();
+    });
+    const fail = (error: unknown) => {
+      const task = this.#busy.get(worker);
+      this.#busy.delete(worker);
+      this.#idle = this.#idle.filter((w) => w !== worker);
+      task?.reject(error);
+      this.#drain();
+    };
+    worker.on("error", fail);
+    worker.on("exit", (code) => fail(new Error(`Worker exited with code ${code}.`)));
+    return worker;
+  }
+}
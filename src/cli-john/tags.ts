@@ -0,0 +1,45 @@
+/**
+ * Built-in Utilities tags. `ansi` and `css` are what InlineStyle#ansi and
+ * InlineStyle#text produce for `style`. From source they are computed on
+ * first use; build.js rewrites dist/cli-john/tags.js with them precomputed,
+ * so logging with the defaults never builds an InlineStyle or a cssom
+ * declaration in the published package.
+ */
+
+import InlineStyle from "../stylesheet/index.js";
+
+export interface TagPreset {
+  config: { tag: string; showErrorInTag: boolean; paddingLeft: number; paddingRight: number };
+  style: { [key: string]: string };
+  ansi: string;
+  css: string;
+}
+
+const TAG_STYLES: Record<string, Pick<TagPreset, "config" | "style">> = {
+  error: {
+    config: { tag: "ERROR", showErrorInTag: false, paddingLeft: 0, paddingRight: 0 },
+    style: { color: "red", fontWeight: "bold" },
+  },
+  warning: {
+    config: { tag: "WARNING", showErrorInTag: true, paddingLeft: 0, paddingRight: 0 },
+    style: { color: "orange", fontWeight: "bold" },
+  },
+  info: {
+    config: { tag: "INFO", showErrorInTag: true, paddingLeft: 0, paddingRight: 0 },
+    style: { color: "blue" },
+  },
+};
+
+let presets: Record<string, TagPreset> | null = null;
+
+/** The default tags by name, in display order. */
+export function defaultTags(): Record<string, TagPreset> {
+  if (presets === null) {
+    presets = {};
+    for (const [name, { config, style }] of Object.entries(TAG_STYLES)) {
+      const inline = new InlineStyle({ ...style });
+      presets[name] = { config, style, ansi: inline.ansi, css: inline.text };
+    }
+  }
+  return presets;
+}
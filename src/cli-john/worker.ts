@@ -0,0 +1,37 @@
+/**
+ * Worker entry for ./pool.ts. Compiles each handler source once, runs it on
+ * the task payload and forwards `Utilities` output to the main thread.
+ */
+
+import { parentPort } from "node:worker_threads";
+import { OutputSink } from "../warner/sink.js";
+import { Utilities } from "./index.js";
+import type { WorkerReply, WorkerTask } from "./pool.js";
+
+const port = parentPort!;
+const post = (reply: WorkerReply) => port.postMessage(reply);
+
+const output = new OutputSink({ target: { write: (text: string) => post({ type: "output", text }) } });
+Utilities.setOutput(output);
+
+const handlers = new Map<string, Function>();
+
+port.on("message", async ({ id, source, payload }: WorkerTask) => {
+  try {
+    let handler = handlers.get(source);
+    if (!handler) {
+      handler = new Function("Utilities", `return (${source});`)(Utilities) as Function;
+      handlers.set(source, handler);
+    }
+    await handler(payload);
+    output.flush();
+    post({ type: "done", id });
+  } catch (error) {
+    output.flush();
+    try {
+      post({ type: "error", id, error });
+    } catch {
+      post({ type: "error", id, error: new Error(String(error)) });
+    }
+  }
+});
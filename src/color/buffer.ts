@@ -0,0 +1,332 @@
+/**
+ * # ColorBuffer
+ * A fixed-size palette stored as columns instead of Color objects.
+ *
+ * One (Shared)ArrayBuffer holds three Uint8ClampedArray planes for red,
+ * green and blue followed by a Float32Array plane for alpha:
+ *
+ *     [ r x n | g x n | b x n | pad to 4 | a x n (float32) ]
+ *
+ * That is 7 bytes per color with no per-color object, and the bulk
+ * operations run over contiguous channel arrays (native kernels when the
+ * addon is loaded, matching loops otherwise). The buffer is a
+ * SharedArrayBuffer where the platform has one, so a palette can be handed
+ * to a worker and used there without copying:
+ *
+ *     worker.postMessage({ buffer: palette.buffer, length: palette.length });
+ *     // in the worker
+ *     const palette = new ColorBuffer(data.length, { buffer: data.buffer });
+ *
+ * Writes are plain stores; coordinate writers the way you would for any
+ * shared memory.
+ */
+
+import { createWarner } from "../warner/index.js";
+import { loadNativeAddon } from "../native/load.js";
+import Color from "./index.js";
+import { CHANNELS, ansiPrefix, rgbToHsl } from "./convert.js";
+import type { ColorNativeAddon } from "./node/index.js";
+
+const bufferWarner = createWarner("@briklab/lib/color");
+const native = loadNativeAddon("color") as ColorNativeAddon | null;
+
+function warnBuffer(scope: string, message: string, hint?: string, otherMessage?: string): void {
+  if (!bufferWarner.enabled) return;
+  bufferWarner.warn({ scope, message, hint, otherMessage });
+}
+
+/** Byte offset of the alpha plane; keep in sync with palette.hpp. */
+function alphaOffset(length: number): number {
+  return (3 * length + 3) & ~3;
+}
+
+/** sRGB channel value 0..255 -> linear light, built on first use. */
+let linear: Float64Array | null = null;
+
+function buildLinear(): Float64Array {
+  const table = new Float64Array(256);
+  for (let v = 0; v < 256; v++) {
+    const c = v / 255;
+    table[v] = c <= 0.04045 ? c / 12.92 : Math.pow((c + 0.055) / 1.055, 2.4);
+  }
+  return table;
+}
+
+/** Shortest decimal that reads back as the same float32, so 0.3 prints as 0.3. */
+function alphaText(a: number): string {
+  if (a === 1 || a === 0) return String(a);
+  for (let digits = 1; digits < 9; digits++) {
+    const short = +a.toPrecision(digits);
+    if (Math.fround(short) === a) return String(short);
+  }
+  return String(a);
+}
+
+function hex2(v: number): string {
+  return v < 16 ? `0${v.toString(16)}` : v.toString(16);
+}
+
+type ColorBufferInput = ConstructorParameters<typeof Color>[0];
+
+export interface ColorBufferOptions {
+  /**
+   * Existing memory to use, e.g. `palette.buffer` received from another
+   * thread. Must hold at least `ColorBuffer.byteLength(length)` bytes.
+   */
+  buffer?: ArrayBuffer | SharedArrayBuffer;
+  /** Allocate a SharedArrayBuffer. Defaults to true where one is available. */
+  shared?: boolean;
+}
+
+export class ColorBuffer {
+  /** Number of colors. */
+  readonly length: number;
+  readonly r: Uint8ClampedArray;
+  readonly g: Uint8ClampedArray;
+  readonly b: Uint8ClampedArray;
+  /** Alpha in 0..1. */
+  readonly a: Float32Array;
+  /** Every byte of the buffer, as handed to the native kernels. */
+  #bytes: Uint8Array;
+
+  /** Bytes needed for `length` colors. */
+  static byteLength(length: number): number {
+    return alphaOffset(length) + 4 * length;
+  }
+
+  /**
+   * ## constructor
+   * `length` colors, all opaque black unless `options.buffer` already holds
+   * a palette.
+   */
+  constructor(length: number, options: ColorBufferOptions = {}) {
+    if (!Number.isInteger(length) || length < 0) {
+      warnBuffer(
+        "ColorBuffer.constructor",
+        `Invalid length ${JSON.stringify(length)}.`,
+        "Expected a non-negative integer.",
+        "Using an empty buffer.",
+      );
+      length = 0;
+    }
+    const size = ColorBuffer.byteLength(length);
+    let buffer = options.buffer;
+    if (buffer !== undefined && !(buffer.byteLength >= size)) {
+      warnBuffer(
+        "ColorBuffer.constructor",
+        `The given buffer holds ${buffer.byteLength} bytes; ${length} colors need ${size}.`,
+        "Allocate it with ColorBuffer.byteLength(length) bytes, or pass the buffer of an existing ColorBuffer.",
+        "Using a new buffer instead.",
+      );
+      buffer = undefined;
+    }
+    const fresh = buffer === undefined;
+    if (!buffer) {
+      const shared = (options.shared ?? true) && typeof SharedArrayBuffer === "function";
+      buffer = shared ? new SharedArrayBuffer(size) : new ArrayBuffer(size);
+    }
+
+    this.length = length;
+    this.r = new Uint8ClampedArray(buffer, 0, length);
+    this.g = new Uint8ClampedArray(buffer, length, length);
+    this.b = new Uint8ClampedArray(buffer, 2 * length, length);
+    this.a = new Float32Array(buffer, alphaOffset(length), length);
+    this.#bytes = new Uint8Array(buffer, 0, size);
+    if (fresh) this.a.fill(1);
+  }
+
+  /** A buffer holding `colors`, parsed like the Color constructor. */
+  static from(colors: readonly ColorBufferInput[], options?: ColorBufferOptions): ColorBuffer {
+    if (!Array.isArray(colors)) {
+      warnBuffer(
+        "ColorBuffer.from",
+        "Invalid first argument.",
+        "Pass an array of colors.",
+        "Using an empty buffer.",
+      );
+      return new ColorBuffer(0, options);
+    }
+    const palette = new ColorBuffer(colors.length, options);
+    if (colors.every((c) => typeof c === "string")) {
+      // Strings skip the Color objects, natively when the addon is loaded.
+      const rgba = new Float64Array(colors.length * 4);
+      Color.parseMany(colors as readonly string[], rgba, Color.RGBAARRAY);
+      for (let i = 0; i < colors.length; i++) {
+        palette.setRgba(i, rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]);
+      }
+    } else {
+      for (let i = 0; i < colors.length; i++) palette.set(i, colors[i]);
+    }
+    return palette;
+  }
+
+  /** The memory behind every plane; pass it to a worker together with `length`. */
+  get buffer(): ArrayBuffer | SharedArrayBuffer {
+    return this.#bytes.buffer as ArrayBuffer | SharedArrayBuffer;
+  }
+
+  /** The color at `i` as a Color object. */
+  get(i: number): Color {
+    if (!this.#has("ColorBuffer.get", i)) return new Color("#000000");
+    return new Color({ r: this.r[i], g: this.g[i], b: this.b[i], a: this.a[i] });
+  }
+
+  /** Store `color` (anything the Color constructor accepts) at `i`. */
+  set(i: number, color: ColorBufferInput): this {
+    if (!this.#has("ColorBuffer.set", i)) return this;
+    const [r, g, b, a] = (color instanceof Color ? color : new Color(color)).rgbaArray();
+    return this.setRgba(i, r, g, b, a);
+  }
+
+  /** Store channels directly: r/g/b 0..255 (rounded and clamped), a 0..1. */
+  setRgba(i: number, r: number, g: number, b: number, a: number = 1): this {
+    if (!this.#has("ColorBuffer.setRgba", i)) return this;
+    this.r[i] = r;
+    this.g[i] = g;
+    this.b[i] = b;
+    this.a[i] = a;
+    return this;
+  }
+
+  hex(i: number): string {
+    if (!this.#has("ColorBuffer.hex", i)) return "#000000";
+    return `#${hex2(this.r[i])}${hex2(this.g[i])}${hex2(this.b[i])}`;
+  }
+
+  rgba(i: number): string {
+    if (!this.#has("ColorBuffer.rgba", i)) return "rgba(0, 0, 0, 1)";
+    return `rgba(${this.r[i]}, ${this.g[i]}, ${this.b[i]}, ${alphaText(this.a[i])})`;
+  }
+
+  hsl(i: number): string {
+    if (!this.#has("ColorBuffer.hsl", i)) return "hsl(0, 0%, 0%)";
+    rgbToHsl(this.r[i], this.g[i], this.b[i]);
+    return `hsl(${CHANNELS[0]}, ${CHANNELS[1]}%, ${CHANNELS[2]}%)`;
+  }
+
+  /** Like Color#css(): hex when opaque, rgba() otherwise. */
+  css(i: number): string {
+    return this.a[i] === 1 ? this.hex(i) : this.rgba(i);
+  }
+
+  /** 24-bit ANSI foreground sequence for the color at `i`. */
+  ansiTruecolor(i: number): string {
+    if (!this.#has("ColorBuffer.ansiTruecolor", i)) return ansiPrefix(0, 0, 0, 0);
+    return ansiPrefix(this.r[i], this.g[i], this.b[i], 0);
+  }
+
+  /**
+   * Mix every color toward white by `amount` (0..1), or toward black for
+   * negative amounts. Alpha is kept. Writes to `out` (default: in place).
+   */
+  lighten(amount: number, out: ColorBuffer = this): ColorBuffer {
+    const n = this.length;
+    if (!this.#fits("ColorBuffer.lighten", out, n)) return out;
+    const t = Math.min(1, Math.abs(Number(amount) || 0));
+    const target = amount < 0 ? 0 : 255;
+    if (native) {
+      native.paletteLighten(this.#bytes, n, t, target, out.#bytes, out.length);
+      return out;
+    }
+    const planes = [this.r, this.g, this.b];
+    const outPlanes = [out.r, out.g, out.b];
+    for (let p = 0; p < 3; p++) {
+      const src = planes[p],
+        dst = outPlanes[p];
+      for (let i = 0; i < n; i++) dst[i] = Math.round(src[i] + (target - src[i]) * t);
+    }
+    if (out !== this) out.a.set(this.a);
+    return out;
+  }
+
+  /**
+   * Blend every color with `other` by `weight` (0 keeps this color, 1 takes
+   * `other`), alpha included. `other` is a buffer of at least this length,
+   * or a single color applied to every entry. Writes to `out` (default: in place).
+   */
+  mix(other: ColorBuffer | ColorBufferInput, weight: number = 0.5, out: ColorBuffer = this): ColorBuffer {
+    const n = this.length;
+    const source = this.#operand("ColorBuffer.mix", other);
+    if (!source || !this.#fits("ColorBuffer.mix", out, n)) return out;
+    const w = Math.max(0, Math.min(1, Number(weight) || 0));
+    if (native) {
+      native.paletteMix(this.#bytes, n, source.#bytes, source.length, w, out.#bytes, out.length);
+      return out;
+    }
+    const step = source.length === 1 ? 0 : 1;
+    const planes = [this.r, this.g, this.b, this.a];
+    const sourcePlanes = [source.r, source.g, source.b, source.a];
+    const outPlanes = [out.r, out.g, out.b, out.a];
+    for (let p = 0; p < 4; p++) {
+      const src = planes[p],
+        mixIn = sourcePlanes[p],
+        dst = outPlanes[p];
+      if (p === 3) {
+        for (let i = 0, j = 0; i < n; i++, j += step) dst[i] = src[i] + (mixIn[j] - src[i]) * w;
+      } else {
+        for (let i = 0, j = 0; i < n; i++, j += step) dst[i] = Math.round(src[i] + (mixIn[j] - src[i]) * w);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * WCAG 2 contrast ratio (1..21) of every color against `other` (a buffer
+   * of at least this length, or one color for all), ignoring alpha. Text
+   * meets AA at 4.5 and AAA at 7.
+   */
+  contrast(other: ColorBuffer | ColorBufferInput, out?: Float32Array): Float32Array {
+    const n = this.length;
+    const result = out instanceof Float32Array && out.length >= n ? out : new Float32Array(n);
+    const against = this.#operand("ColorBuffer.contrast", other);
+    if (!against) return result;
+    const table = linear ?? (linear = buildLinear());
+    if (native) {
+      native.paletteContrast(this.#bytes, n, against.#bytes, against.length, table, result);
+      return result;
+    }
+    const step = against.length === 1 ? 0 : 1;
+    const { r, g, b } = this;
+    for (let i = 0, j = 0; i < n; i++, j += step) {
+      const x = 0.2126 * table[r[i]] + 0.7152 * table[g[i]] + 0.0722 * table[b[i]];
+      const y = 0.2126 * table[against.r[j]] + 0.7152 * table[against.g[j]] + 0.0722 * table[against.b[j]];
+      result[i] = x > y ? (x + 0.05) / (y + 0.05) : (y + 0.05) / (x + 0.05);
+    }
+    return result;
+  }
+
+  #has(scope: string, i: number): boolean {
+    if (i >= 0 && i < this.length && Number.isInteger(i)) return true;
+    warnBuffer(
+      scope,
+      `Index ${JSON.stringify(i)} is out of range.`,
+      `Expected an integer from 0 to ${this.length - 1}.`,
+      "Using black as fallback.",
+    );
+    return false;
+  }
+
+  #fits(scope: string, out: ColorBuffer, n: number): boolean {
+    if (out instanceof ColorBuffer && out.length >= n) return true;
+    warnBuffer(
+      scope,
+      "Invalid output buffer.",
+      `Pass a ColorBuffer of at least ${n} colors.`,
+      "Nothing was written.",
+    );
+    return false;
+  }
+
+  /** `other` as a buffer the kernels can read: one color, or one per entry. */
+  #operand(scope: string, other: ColorBuffer | ColorBufferInput): ColorBuffer | null {
+    if (!(other instanceof ColorBuffer)) return new ColorBuffer(1, { shared: false }).set(0, other);
+    if (other.length === 1 || other.length >= this.length) return other;
+    warnBuffer(
+      scope,
+      `The other buffer holds ${other.length} colors; this one holds ${this.length}.`,
+      "Pass a buffer of at least the same length, or a single color.",
+      "Nothing was written.",
+    );
+    return null;
+  }
+}
@@ -0,0 +1,158 @@
+/**
+ * Channel conversions and interned ANSI sequences shared by Color and
+ * ColorBuffer. Not part of the public API.
+ */
+
+const BOLD = "\x1b[1m";
+const UNDERLINE = "\x1b[4m";
+
+/** Channel levels of the xterm 6x6x6 color cube (palette 16..231). */
+const ANSI256_CUBE_LEVELS = [0, 95, 135, 175, 215, 255];
+
+/** Nearest cube level (0..5) for every channel value 0..255, built on first use. */
+let ansi256CubeIndex: Uint8Array | null = null;
+
+function buildAnsi256CubeIndex(): Uint8Array {
+  const table = new Uint8Array(256);
+  for (let v = 0, level = 0; v < 256; v++) {
+    if (level < 5 && v - ANSI256_CUBE_LEVELS[level] > ANSI256_CUBE_LEVELS[level + 1] - v) level++;
+    table[v] = level;
+  }
+  return table;
+}
+
+/**
+ * Nearest of the 240 non-system palette entries (cube 16..231, grays 232..255).
+ * Distance is Euclidean with 2/4/3 channel weights, which is separable: the
+ * best cube entry is the per-channel nearest level and the best gray is the
+ * one nearest to the weighted mean, so the lookup is O(1) and exact.
+ */
+function rgbToAnsi256Index(r: number, g: number, b: number): number {
+  const cube = ansi256CubeIndex ?? (ansi256CubeIndex = buildAnsi256CubeIndex());
+  r |= 0;
+  g |= 0;
+  b |= 0;
+  const cr = cube[r],
+    cg = cube[g],
+    cb = cube[b];
+  const lr = ANSI256_CUBE_LEVELS[cr],
+    lg = ANSI256_CUBE_LEVELS[cg],
+    lb = ANSI256_CUBE_LEVELS[cb];
+  const cubeDist = 2 * (r - lr) ** 2 + 4 * (g - lg) ** 2 + 3 * (b - lb) ** 2;
+
+  const grayIndex = Math.max(0, Math.min(23, Math.round(((2 * r + 4 * g + 3 * b) / 9 - 8) / 10)));
+  const gray = 8 + grayIndex * 10;
+  const grayDist = 2 * (r - gray) ** 2 + 4 * (g - gray) ** 2 + 3 * (b - gray) ** 2;
+
+  return grayDist < cubeDist ? 232 + grayIndex : 16 + 36 * cr + 6 * cg + cb;
+}
+
+/** Flags of an interned ANSI prefix. */
+export const ANSI_BG = 1;
+export const ANSI_256 = 2;
+export const ANSI_BOLD = 4;
+export const ANSI_UNDERLINE = 8;
+
+/** Interned ANSI escape prefixes keyed by packed RGB and flags, oldest entries are evicted first. */
+const ANSI_CACHE_LIMIT = 1024;
+const ansiCache = new Map<number, string>();
+
+function buildAnsiPrefix(r: number, g: number, b: number, flags: number): string {
+  const mods = `${flags & ANSI_BOLD ? BOLD : ""}${flags & ANSI_UNDERLINE ? UNDERLINE : ""}`;
+  const layer = flags & ANSI_BG ? 48 : 38;
+  return flags & ANSI_256
+    ? `${mods}\x1b[${layer};5;${rgbToAnsi256Index(r, g, b)}m`
+    : `${mods}\x1b[${layer};2;${r};${g};${b}m`;
+}
+
+export function ansiPrefix(r: number, g: number, b: number, flags: number): string {
+  // Only integral channels are interned; anything else is rare and built directly.
+  if ((r & 0xff) !== r || (g & 0xff) !== g || (b & 0xff) !== b) {
+    return buildAnsiPrefix(r, g, b, flags);
+  }
+  const key = ((r << 16) | (g << 8) | b) * 16 + flags;
+  let seq = ansiCache.get(key);
+  if (seq === undefined) {
+    seq = buildAnsiPrefix(r, g, b, flags);
+    if (ansiCache.size >= ANSI_CACHE_LIMIT) ansiCache.delete(ansiCache.keys().next().value!);
+    ansiCache.set(key, seq);
+  }
+  return seq;
+}
+
+/** Scratch output of the conversion helpers below, avoids a result object per call. */
+export const CHANNELS = new Float64Array(3);
+
+export function clamp255(value: number): number {
+  return Math.max(0, Math.min(255, value));
+}
+
+export function unitTo255(value: number): number {
+  // Accept both 0..1 unit values and 0..255 values.
+  if (value >= 0 && value <= 1) {
+    return clamp255(Math.round(value * 255));
+  }
+  return clamp255(Math.round(value));
+}
+
+/** HSL (0..360, 0..100, 0..100) to unrounded RGB, written to CHANNELS. */
+export function hslToRgbExact(h: number, s: number, l: number): void {
+  s /= 100;
+  l /= 100;
+  const k = (n: number) => (n + h / 30) % 12;
+  const a = s * Math.min(l, 1 - l);
+  const f = (n: number) => l - a * Math.max(-1, Math.min(k(n) - 3, Math.min(9 - k(n), 1)));
+  CHANNELS[0] = f(0) * 255;
+  CHANNELS[1] = f(8) * 255;
+  CHANNELS[2] = f(4) * 255;
+}
+
+/** HSL (0..360, 0..100, 0..100) to integer RGB, written to CHANNELS. */
+export function hslToRgb(h: number, s: number, l: number): void {
+  hslToRgbExact(h, s, l);
+  roundChannels();
+}
+
+/** RGB (0..255) to integer HSL, written to CHANNELS. */
+export function rgbToHsl(r: number, g: number, b: number): void {
+  rgbToHslExact(r, g, b);
+  roundChannels();
+}
+
+function roundChannels(): void {
+  CHANNELS[0] = Math.round(CHANNELS[0]);
+  CHANNELS[1] = Math.round(CHANNELS[1]);
+  CHANNELS[2] = Math.round(CHANNELS[2]);
+}
+
+/** RGB (0..255) to unrounded HSL, written to CHANNELS. */
+export function rgbToHslExact(r: number, g: number, b: number): void {
+  r /= 255;
+  g /= 255;
+  b /= 255;
+  const max = Math.max(r, g, b),
+    min = Math.min(r, g, b);
+  let h = 0,
+    s = 0,
+    l = (max + min) / 2;
+
+  if (max !== min) {
+    const d = max - min;
+    s = l > 0.5 ? d / (2 - max - min) : d / (max + min);
+    switch (max) {
+      case r:
+        h = (g - b) / d + (g < b ? 6 : 0);
+        break;
+      case g:
+        h = (b - r) / d + 2;
+        break;
+      case b:
+        h = (r - g) / d + 4;
+        break;
+    }
+    h *= 60;
+  }
+  CHANNELS[0] = h;
+  CHANNELS[1] = s * 100;
+  CHANNELS[2] = l * 100;
+}
@@ -5,9 +5,26 @@
 import { createWarner } from "../warner/index.js";
 import type { ProtectionLevel } from "../jstc/index.js";
 import { loadNativeAddon } from "../native/load.js";
+import type { ColorNativeAddon } from "./node/index.js";
+import {
+  ANSI_256,
+  ANSI_BG,
+  ANSI_BOLD,
+  ANSI_UNDERLINE,
+  CHANNELS,
+  ansiPrefix,
+  clamp255,
+  hslToRgb,
+  hslToRgbExact,
+  rgbToHsl,
+  rgbToHslExact,
+  unitTo255,
+} from "./convert.js";
+import { NAMED_COLORS } from "./named.js";
 
 const colorWarner = createWarner("@briklab/lib/color");
-export const native = loadNativeAddon(import.meta.url, "color");
+export const native = loadNativeAddon("color") as ColorNativeAddon | null;
+const nativeAlpha = new Float64Array(1);
 
 function formatColorMessage(
   scope: string,
@@ -24,6 +41,12 @@ function formatColorMessage(
     .join("\n");
 }
 
+/** Report a color warning; the warner formats it only if it is printed. */
+function warnColor(scope: string, message: string, hint?: string, otherMessage?: string): void {
+  if (!colorWarner.enabled) return;
+  colorWarner.warn({ scope, message, hint, otherMessage });
+}
+
 type ColorFormat =
   | "auto"
   | "rgb"
@@ -39,6 +62,20 @@ type ColorFormat =
   | "hslaobj"
   | "hslaarray";
 
+/** Options object accepted in place of the format / protection level arguments. */
+export interface ColorOptions {
+  format?: ColorFormat;
+  protectionLevel?: ProtectionLevel;
+  /**
+   * Keep fractional channels instead of rounding them to integers, and keep
+   * HSL input as given, so `new Color("hsl(210, 33.3%, 40%)", { precise: true }).hsl()`
+   * returns the input unchanged. Strings are printed with at most 3
+   * decimals; hex and ANSI output round to bytes. Defaults to the mode of
+   * the input when copying a Color.
+   */
+  precise?: boolean;
+}
+
 type ColorInput =
   | string
   | Color
@@ -46,17 +83,80 @@ type ColorInput =
   | { r?: number; g?: number; b?: number; a?: number }
   | { h?: number; s?: number; l?: number; a?: number };
 
-const NAMED_COLORS: Record<string, string> = {
-  red: "#ff0000",
-  blue: "#0000ff",
-  green: "#00ff00",
-  yellow: "#ffff00",
-  orange: "#ffa500",
-  black: "#000000",
-  white: "#ffffff",
-  gray: "#808080",
+/**
+ * Output/input buffer of the batch APIs: 4 values per color.
+ * A Uint8ClampedArray always holds RGBA with alpha in 0..255 (ImageData layout).
+ */
+export type ColorBatchArray = Float32Array | Float64Array | Uint8ClampedArray;
+
+/** Batch layouts, by the same names as the Color format constants. Shared with the native addon. */
+const BATCH_FORMATS: Partial<Record<ColorFormat, number>> = {
+  rgbaarray: 0,
+  unitrgba: 1,
+  hslaarray: 2,
 };
 
+function isBatchArray(value: unknown): value is ColorBatchArray {
+  return (
+    value instanceof Float32Array ||
+    value instanceof Float64Array ||
+    value instanceof Uint8ClampedArray
+  );
+}
+
+function batchFormatCode(scope: string, buffer: unknown, format: ColorFormat): number {
+  const code = BATCH_FORMATS[format];
+  if (!isBatchArray(buffer)) {
+    warnColor(
+      scope,
+      "Invalid buffer.",
+      "Pass a Float32Array, Float64Array or Uint8ClampedArray with 4 values per color.",
+      "Nothing was converted.",
+    );
+    return -1;
+  }
+  if (code === undefined || (buffer instanceof Uint8ClampedArray && code !== 0)) {
+    warnColor(
+      scope,
+      `Unsupported batch format "${format}".`,
+      "Use Color.RGBAARRAY, Color.UNITRGBA or Color.HSLAARRAY; Uint8ClampedArray buffers only support Color.RGBAARRAY.",
+      "Nothing was converted.",
+    );
+    return -1;
+  }
+  return code;
+}
+
+/** Write one color to `out` at color index `i` in batch format `to`. */
+function writeBatch(
+  out: ColorBatchArray,
+  i: number,
+  to: number,
+  r: number,
+  g: number,
+  b: number,
+  a: number,
+): void {
+  const o = i * 4;
+  if (to === 2) {
+    rgbToHsl(r, g, b);
+    out[o] = CHANNELS[0];
+    out[o + 1] = CHANNELS[1];
+    out[o + 2] = CHANNELS[2];
+    out[o + 3] = a;
+  } else if (to === 1) {
+    out[o] = r / 255;
+    out[o + 1] = g / 255;
+    out[o + 2] = b / 255;
+    out[o + 3] = a;
+  } else {
+    out[o] = r;
+    out[o + 1] = g;
+    out[o + 2] = b;
+    out[o + 3] = out instanceof Uint8ClampedArray ? a * 255 : a;
+  }
+}
+
 export class Color {
   static AUTO: ColorFormat = "auto";
   static RGB: ColorFormat = "rgb";
@@ -78,10 +178,13 @@ export class Color {
   private b: number = 0;
   private a: number = 1;
   private protectionLevel: ProtectionLevel = "boundary";
+  private isPrecise: boolean = false;
+  /** [h, s, l], computed on first use; Colors never change after construction. */
+  private hslCache: [number, number, number] | null = null;
 
   constructor(
     input: ColorInput,
-    formatOrProtection?: ColorFormat | ProtectionLevel,
+    formatOrProtection?: ColorFormat | ProtectionLevel | ColorOptions,
     protectionLevel?: ProtectionLevel,
   ) {
     let format: ColorFormat = "auto";
@@ -93,6 +196,12 @@ export class Color {
       } else {
         format = formatOrProtection as ColorFormat;
       }
+    } else if (typeof formatOrProtection === "object" && formatOrProtection !== null) {
+      format = formatOrProtection.format ?? format;
+      protectionLevel = formatOrProtection.protectionLevel ?? protectionLevel;
+      this.isPrecise = formatOrProtection.precise ?? (input instanceof Color && input.isPrecise);
+    } else if (input instanceof Color) {
+      this.isPrecise = input.isPrecise;
     }
 
     if (protectionLevel && ["none", "boundary", "sandbox", "hardened"].includes(protectionLevel)) {
@@ -102,10 +211,12 @@ export class Color {
     if (typeof input === "string") {
       this.#parseString(input);
     } else if (input instanceof Color) {
-      this.r = input.r;
-      this.g = input.g;
-      this.b = input.b;
+      const round = input.isPrecise && !this.isPrecise;
+      this.r = round ? Math.round(input.r) : input.r;
+      this.g = round ? Math.round(input.g) : input.g;
+      this.b = round ? Math.round(input.b) : input.b;
       this.a = input.a;
+      if (input.isPrecise === this.isPrecise) this.hslCache = input.hslCache;
     } else if (Array.isArray(input)) {
       this.#parseArray(input, format);
     } else if (typeof input === "object" && input !== null) {
@@ -164,22 +275,18 @@ export class Color {
         )
       );
     } else if (this.protectionLevel === "sandbox") {
-      colorWarner.warn({
-        message: formatColorMessage(
-          "Color.constructor",
-          "Invalid color input.",
-          "Expected a string, an RGB object, or an HSL object.",
-        ),
-      });
+      warnColor(
+        "Color.constructor",
+        "Invalid color input.",
+        "Expected a string, an RGB object, or an HSL object.",
+      );
     } else if (this.protectionLevel === "boundary") {
-      colorWarner.warn({
-        message: formatColorMessage(
-          "Color.constructor",
-          "Invalid color input.",
-          "Expected a string, an RGB object, or an HSL object.",
-          "Using black as fallback.",
-        ),
-      });
+      warnColor(
+        "Color.constructor",
+        "Invalid color input.",
+        "Expected a string, an RGB object, or an HSL object.",
+        "Using black as fallback.",
+      );
     }
     // "none" - silent fallback
   }
@@ -187,26 +294,34 @@ export class Color {
   // -----------------------
   // Public Methods
   // -----------------------
+  /** Whether this color keeps fractional channels (see ColorOptions.precise). */
+  get precise(): boolean {
+    return this.isPrecise;
+  }
+
   hex(): string {
+    if (this.isPrecise) {
+      return `#${this.#toHex(Math.round(this.r))}${this.#toHex(Math.round(this.g))}${this.#toHex(Math.round(this.b))}`;
+    }
     return `#${this.#toHex(this.r)}${this.#toHex(this.g)}${this.#toHex(this.b)}`;
   }
 
   rgb(): string {
-    return `rgb(${this.r}, ${this.g}, ${this.b})`;
+    return `rgb(${this.#text(this.r)}, ${this.#text(this.g)}, ${this.#text(this.b)})`;
   }
 
   rgba(): string {
-    return `rgba(${this.r}, ${this.g}, ${this.b}, ${this.a})`;
+    return `rgba(${this.#text(this.r)}, ${this.#text(this.g)}, ${this.#text(this.b)}, ${this.a})`;
   }
 
   hsl(): string {
-    const { h, s, l } = this.#rgbToHsl(this.r, this.g, this.b);
-    return `hsl(${h}, ${s}%, ${l}%)`;
+    const [h, s, l] = this.#hslValues();
+    return `hsl(${this.#text(h)}, ${this.#text(s)}%, ${this.#text(l)}%)`;
   }
 
   hsla(): string {
-    const { h, s, l } = this.#rgbToHsl(this.r, this.g, this.b);
-    return `hsla(${h}, ${s}%, ${l}%, ${this.a})`;
+    const [h, s, l] = this.#hslValues();
+    return `hsla(${this.#text(h)}, ${this.#text(s)}%, ${this.#text(l)}%, ${this.a})`;
   }
 
   css(): string {
@@ -219,63 +334,43 @@ export class Color {
 
   /** Return a 24-bit (truecolor) ANSI sequence for this color (foreground) */
   ansiTruecolor(): string {
-    return `\x1b[38;2;${this.r};${this.g};${this.b}m`;
+    return this.#ansi(0);
   }
 
   /** Return a 24-bit (truecolor) ANSI sequence for background */
   ansiTruecolorBg(): string {
-    return `\x1b[48;2;${this.r};${this.g};${this.b}m`;
-  }
-
-  /** Convert RGB to the nearest 256-color palette index */
-  #rgbToAnsi256Index(r: number, g: number, b: number): number {
-    // grayscale range
-    if (r === g && g === b) {
-      if (r < 8) return 16;
-      if (r > 248) return 231;
-      return Math.round(((r - 8) / 247) * 24) + 232;
-    }
-    const to6 = (v: number) => Math.round((v / 255) * 5);
-    const ri = to6(r);
-    const gi = to6(g);
-    const bi = to6(b);
-    return 16 + 36 * ri + 6 * gi + bi;
+    return this.#ansi(ANSI_BG);
   }
 
   /** Return a 256-color ANSI sequence for this color (foreground) */
   ansi256(): string {
-    const idx = this.#rgbToAnsi256Index(this.r, this.g, this.b);
-    return `\x1b[38;5;${idx}m`;
+    return this.#ansi(ANSI_256);
   }
 
   /** Return a 256-color ANSI sequence for background */
   ansi256Bg(): string {
-    const idx = this.#rgbToAnsi256Index(this.r, this.g, this.b);
-    return `\x1b[48;5;${idx}m`;
+    return this.#ansi(ANSI_256 | ANSI_BG);
   }
 
   /** Wrap text with this color (truecolor by default). Options: {background?: boolean, use256?: boolean, bold?: boolean, underline?: boolean} */
   wrapAnsi(text: string, opts: { background?: boolean; use256?: boolean; bold?: boolean; underline?: boolean } = {}) {
-    const use256 = Boolean(opts.use256);
-    const seq = opts.background
-      ? use256
-        ? this.ansi256Bg()
-        : this.ansiTruecolorBg()
-      : use256
-      ? this.ansi256()
-      : this.ansiTruecolor();
-    const mods = `${opts.bold ? Color.BOLD : ""}${opts.underline ? Color.UNDERLINE : ""}`;
-    return `${mods}${seq}${text}${Color.RESET}`;
+    const flags =
+      (opts.background ? ANSI_BG : 0) |
+      (opts.use256 ? ANSI_256 : 0) |
+      (opts.bold ? ANSI_BOLD : 0) |
+      (opts.underline ? ANSI_UNDERLINE : 0);
+    return `${this.#ansi(flags)}${text}${Color.RESET}`;
   }
   rgbaArray():[number,number,number,number]{
     return [this.r||0,this.g||0,this.b||0,this.a||1]
   }
   hslaArray():[number,number,number,number]{
-    const {h,s,l} = this.#rgbToHsl(this.r,this.g,this.b)
+    const [h,s,l] = this.#hslValues()
     return [h||0,s||0,l||0,this.a||1]
   }
   hslaObj(){
-    return {a:this.a,...this.#rgbToHsl(this.r,this.g,this.b)}
+    const [h,s,l] = this.#hslValues()
+    return {a:this.a,h,s,l}
   }
   rgbaObj(){
      const {r,g,b,a}=this;
@@ -289,8 +384,115 @@ export class Color {
     const {r,g,b,a} = this;
     return [r/255,g/255,b/255,a]
   }
+
+  /**
+   * ### Color.parseMany
+   * Parse CSS color strings straight into `out` (4 values per color) without
+   * creating Color objects. `format` is Color.RGBAARRAY, Color.UNITRGBA or
+   * Color.HSLAARRAY. Invalid strings fall back to black and warn like the
+   * constructor does. Returns the number of colors written.
+   */
+  static parseMany(
+    inputs: readonly string[],
+    out: ColorBatchArray,
+    format: ColorFormat = "rgbaarray",
+  ): number {
+    const to = batchFormatCode("Color.parseMany", out, format);
+    if (to < 0) return 0;
+    if (!Array.isArray(inputs)) {
+      warnColor(
+        "Color.parseMany",
+        "Invalid first argument.",
+        "Pass an array of color strings.",
+        "Nothing was converted.",
+      );
+      return 0;
+    }
+    const n = Math.min(inputs.length, out.length >> 2);
+
+    if (native) {
+      // The addon writes every string it understands and hands back the rest.
+      const declined = native.parseMany(inputs, out, to);
+      for (let k = 0; k < declined.length; k++) {
+        const i = declined[k];
+        if (i >= n) continue;
+        const c = new Color(inputs[i]);
+        writeBatch(out, i, to, c.r, c.g, c.b, c.a);
+      }
+      return n;
+    }
+
+    for (let i = 0; i < n; i++) {
+      const c = new Color(inputs[i]);
+      writeBatch(out, i, to, c.r, c.g, c.b, c.a);
+    }
+    return n;
+  }
+
+  /**
+   * ### Color.convertMany
+   * Convert packed colors from one batch format to another, e.g.
+   * `Color.convertMany(hsla, Color.HSLAARRAY, rgba, Color.RGBAARRAY)`.
+   * Values are decoded like the array constructor and encoded like
+   * rgbaArray()/unitRgbaArray()/hslaArray(). `input` and `out` may be the
+   * same buffer. Returns the number of colors written.
+   */
+  static convertMany(
+    input: ColorBatchArray,
+    from: ColorFormat,
+    out: ColorBatchArray,
+    to: ColorFormat,
+  ): number {
+    const fromCode = batchFormatCode("Color.convertMany", input, from);
+    const toCode = fromCode < 0 ? -1 : batchFormatCode("Color.convertMany", out, to);
+    if (toCode < 0) return 0;
+    const n = Math.min(input.length >> 2, out.length >> 2);
+
+    if (native) return native.convertMany(input, fromCode, out, toCode);
+
+    const alphaBytes = input instanceof Uint8ClampedArray;
+    for (let i = 0; i < n; i++) {
+      const o = i * 4;
+      const x = input[o],
+        y = input[o + 1],
+        z = input[o + 2],
+        a = alphaBytes ? input[o + 3] / 255 : input[o + 3];
+      if (fromCode === 2) {
+        hslToRgb(x, y, z);
+        writeBatch(out, i, toCode, CHANNELS[0], CHANNELS[1], CHANNELS[2], a);
+      } else if (fromCode === 1) {
+        writeBatch(out, i, toCode, unitTo255(x), unitTo255(y), unitTo255(z), a);
+      } else {
+        writeBatch(out, i, toCode, clamp255(x), clamp255(y), clamp255(z), a);
+      }
+    }
+    return n;
+  }
+
   #clamp(value: number): number {
-    return Math.max(0, Math.min(255, value));
+    return clamp255(value);
+  }
+
+  #round(value: number): number {
+    return this.isPrecise ? value : Math.round(value);
+  }
+
+  /** A channel for string output: as stored, or to 3 decimals in precise mode. */
+  #text(value: number): number {
+    return this.isPrecise ? Math.round(value * 1000) / 1000 : value;
+  }
+
+  #ansi(flags: number): string {
+    if (!this.isPrecise) return ansiPrefix(this.r, this.g, this.b, flags);
+    return ansiPrefix(Math.round(this.r), Math.round(this.g), Math.round(this.b), flags);
+  }
+
+  #hslValues(): [number, number, number] {
+    if (this.hslCache === null) {
+      (this.isPrecise ? rgbToHslExact : rgbToHsl)(this.r, this.g, this.b);
+      this.hslCache = [CHANNELS[0], CHANNELS[1], CHANNELS[2]];
+    }
+    return this.hslCache;
   }
 
   #toHex(value: number): string {
@@ -298,7 +500,31 @@ export class Color {
   }
 
   #parseString(str: string) {
-    str = str.trim().toLowerCase();
+    // Names usually arrive trimmed and lowercase; as given, they resolve
+    // here without crossing into the addon.
+    let named = NAMED_COLORS.get(str);
+    if (named === undefined) {
+      // The addon rounds channels, so precise colors stay on the TS parser.
+      if (native && !this.isPrecise) {
+        const packed = native.parse(str, nativeAlpha);
+        if (packed >= 0) {
+          this.r = packed >>> 24;
+          this.g = (packed >>> 16) & 0xff;
+          this.b = (packed >>> 8) & 0xff;
+          this.a = nativeAlpha[0];
+          return;
+        }
+      }
+      str = str.trim().toLowerCase();
+      named = NAMED_COLORS.get(str);
+    }
+    if (named !== undefined) {
+      this.r = named >>> 16;
+      this.g = (named >>> 8) & 0xff;
+      this.b = named & 0xff;
+      this.a = 1;
+      return;
+    }
 
     if (str === "transparent") {
       this.r = 0;
@@ -308,10 +534,6 @@ export class Color {
       return;
     }
 
-    if (NAMED_COLORS[str]) {
-      str = NAMED_COLORS[str];
-    }
-
     if (str.startsWith("#")) {
       return this.#parseHex(str);
     }
@@ -487,11 +709,8 @@ export class Color {
   }
 
   #unitTo255(value: number): number {
-    // Accept both 0..1 unit values and 0..255 values.
-    if (value >= 0 && value <= 1) {
-      return this.#clamp(Math.round(value * 255));
-    }
-    return this.#clamp(Math.round(value));
+    if (!this.isPrecise) return unitTo255(value);
+    return clamp255(value >= 0 && value <= 1 ? value * 255 : value);
   }
 
   #parseRgbComponent(component: string): number | null {
@@ -499,7 +718,7 @@ export class Color {
     if (component.endsWith("%")) {
       const pct = parseFloat(component.slice(0, -1));
       if (Number.isNaN(pct)) return null;
-      return this.#clamp(Math.round((pct / 100) * 255));
+      return this.#clamp(this.#round((pct / 100) * 255));
     }
 
     const value = parseFloat(component);
@@ -507,10 +726,10 @@ export class Color {
 
     // Support CSS unit rgb values in [0,1], where 1 -> 255
     if (value >= 0 && value <= 1) {
-      return this.#clamp(Math.round(value * 255));
+      return this.#clamp(this.#round(value * 255));
     }
 
-    return this.#clamp(Math.round(value));
+    return this.#clamp(this.#round(value));
   }
 
   #parseAlpha(value: string): number | null {
@@ -546,51 +765,23 @@ export class Color {
   }
 
   #warnInvalidString(str: string, hint?: string) {
-    const message = formatColorMessage(
+    warnColor(
       "Color.parseString",
       `Unknown color string "${str}".`,
       "The value must be a valid color string.",
       hint ?? "Using black as fallback.",
     );
-    colorWarner.warn({ message });
   }
 
   #hslToRgb(h: number, s: number, l: number) {
-    s /= 100;
-    l /= 100;
-    const k = (n: number) => (n + h / 30) % 12;
-    const a = s * Math.min(l, 1 - l);
-    const f = (n: number) => l - a * Math.max(-1, Math.min(k(n) - 3, Math.min(9 - k(n), 1)));
-    return { r: Math.round(f(0) * 255), g: Math.round(f(8) * 255), b: Math.round(f(4) * 255) };
-  }
-
-  #rgbToHsl(r: number, g: number, b: number) {
-    r /= 255;
-    g /= 255;
-    b /= 255;
-    const max = Math.max(r, g, b),
-      min = Math.min(r, g, b);
-    let h = 0,
-      s = 0,
-      l = (max + min) / 2;
-
-    if (max !== min) {
-      const d = max - min;
-      s = l > 0.5 ? d / (2 - max - min) : d / (max + min);
-      switch (max) {
-        case r:
-          h = (g - b) / d + (g < b ? 6 : 0);
-          break;
-        case g:
-          h = (b - r) / d + 2;
-          break;
-        case b:
-          h = (r - g) / d + 4;
-          break;
-      }
-      h *= 60;
+    if (this.isPrecise) {
+      hslToRgbExact(h, s, l);
+      // HSL input is kept as given, so it formats back unchanged.
+      this.hslCache = [h, s, l];
+    } else {
+      hslToRgb(h, s, l);
     }
-    return { h: Math.round(h), s: Math.round(s * 100), l: Math.round(l * 100) };
+    return { r: CHANNELS[0], g: CHANNELS[1], b: CHANNELS[2] };
   }
 }
 export namespace Color {
@@ -604,6 +795,8 @@ export namespace Color {
     return new Color(hsla)
   }
 }
+export { ColorBuffer } from "./buffer.js";
+export type { ColorBufferOptions } from "./buffer.js";
 export default Color;
 
 
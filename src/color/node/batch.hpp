@@ -0,0 +1,290 @@
+// Batch color conversion kernels behind Color.parseMany / Color.convertMany.
+//
+// Colors are processed in blocks of kLanes: each block is deinterleaved into
+// per-channel arrays, converted with branch-free arithmetic the compiler
+// vectorizes, and interleaved back. Lanes holding NaN (or hues outside
+// [0, 360)) take a scalar path that follows the JS semantics of
+// src/color/index.ts exactly, so both paths produce identical buffers.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "cpu.hpp"
+#include "parse.hpp"
+
+namespace briklab::color {
+
+// Keep in sync with BATCH_FORMATS in src/color/index.ts.
+enum class Format : int { Rgba = 0, UnitRgba = 1, Hsla = 2 };
+
+inline constexpr std::size_t kLanes = 8;
+
+struct Block {
+  double r[kLanes];
+  double g[kLanes];
+  double b[kLanes];
+  double a[kLanes];
+};
+
+// ---- JS number semantics -------------------------------------------------
+
+inline double jsMin(double x, double y) { return (std::isnan(x) || std::isnan(y)) ? NAN : std::min(x, y); }
+inline double jsMax(double x, double y) { return (std::isnan(x) || std::isnan(y)) ? NAN : std::max(x, y); }
+inline double jsClamp255(double v) { return std::isnan(v) ? v : clamp(v, 0, 255); }
+
+inline double jsUnitTo255(double v) {
+  return jsClamp255((v >= 0 && v <= 1) ? jsRound(v * 255) : jsRound(v));
+}
+
+// Scalar twin of hslToRgb() in src/color/index.ts, including NaN and
+// out-of-range hues.
+inline void hslToRgbScalar(double h, double s, double l, double& r, double& g, double& b) {
+  s /= 100;
+  l /= 100;
+  const double a = s * jsMin(l, 1 - l);
+  auto f = [&](double n) {
+    const double k = std::fmod(n + h / 30, 12);
+    return l - a * jsMax(-1, jsMin(k - 3, jsMin(9 - k, 1)));
+  };
+  r = jsRound(f(0) * 255);
+  g = jsRound(f(8) * 255);
+  b = jsRound(f(4) * 255);
+}
+
+// Scalar twin of rgbToHsl() in src/color/index.ts.
+inline void rgbToHslScalar(double r, double g, double b, double& h, double& s, double& l) {
+  r /= 255;
+  g /= 255;
+  b /= 255;
+  const double max = jsMax(r, jsMax(g, b));
+  const double min = jsMin(r, jsMin(g, b));
+  h = 0;
+  s = 0;
+  l = (max + min) / 2;
+  if (!(max == min)) {
+    const double d = max - min;
+    s = l > 0.5 ? d / (2 - max - min) : d / (max + min);
+    if (max == r) {
+      h = (g - b) / d + (g < b ? 6 : 0);
+    } else if (max == g) {
+      h = (b - r) / d + 2;
+    } else if (max == b) {
+      h = (r - g) / d + 4;
+    }
+    h *= 60;
+  }
+  h = jsRound(h);
+  s = jsRound(s * 100);
+  l = jsRound(l * 100);
+}
+
+// ---- Block kernels --------------------------------------------------------
+
+// In place: (h, s, l) in r/g/b -> integer RGB.
+inline void hslToRgbBlock(Block& blk, std::size_t m) {
+  bool slow = false;
+  for (std::size_t i = 0; i < m; i++) {
+    slow |= !(blk.r[i] >= 0 && blk.r[i] < 360 && blk.g[i] == blk.g[i] && blk.b[i] == blk.b[i]);
+  }
+
+  double out[3][kLanes];
+  for (std::size_t i = 0; i < m; i++) {
+    const double h30 = blk.r[i] / 30;
+    const double s = blk.g[i] / 100;
+    const double l = blk.b[i] / 100;
+    const double a = s * std::min(l, 1 - l);
+    const double n[3] = {0, 8, 4};
+    for (int c = 0; c < 3; c++) {
+      // n + h/30 lies in [0, 20) here, so fmod(x, 12) is a single exact subtraction.
+      const double x = n[c] + h30;
+      const double k = x >= 12 ? x - 12 : x;
+      out[c][i] = jsRound((l - a * std::max(-1.0, std::min(k - 3, std::min(9 - k, 1.0)))) * 255);
+    }
+  }
+
+  if (slow) {
+    for (std::size_t i = 0; i < m; i++) {
+      if (blk.r[i] >= 0 && blk.r[i] < 360 && blk.g[i] == blk.g[i] && blk.b[i] == blk.b[i]) continue;
+      hslToRgbScalar(blk.r[i], blk.g[i], blk.b[i], out[0][i], out[1][i], out[2][i]);
+    }
+  }
+  std::copy_n(out[0], m, blk.r);
+  std::copy_n(out[1], m, blk.g);
+  std::copy_n(out[2], m, blk.b);
+}
+
+// In place: integer RGB in r/g/b -> (h, s, l).
+inline void rgbToHslBlock(Block& blk, std::size_t m) {
+  bool slow = false;
+  for (std::size_t i = 0; i < m; i++) {
+    slow |= !(blk.r[i] == blk.r[i] && blk.g[i] == blk.g[i] && blk.b[i] == blk.b[i]);
+  }
+
+  double hs[kLanes], ss[kLanes], ls[kLanes];
+  for (std::size_t i = 0; i < m; i++) {
+    const double r = blk.r[i] / 255, g = blk.g[i] / 255, b = blk.b[i] / 255;
+    const double max = std::max(r, std::max(g, b));
+    const double min = std::min(r, std::min(g, b));
+    const double l = (max + min) / 2;
+    const double d = max - min;
+    const double s = l > 0.5 ? d / (2 - max - min) : d / (max + min);
+    const double h = max == r ? (g - b) / d + (g < b ? 6 : 0) : max == g ? (b - r) / d + 2 : (r - g) / d + 4;
+    const bool gray = max == min;
+    hs[i] = jsRound(gray ? 0 : h * 60);
+    ss[i] = jsRound(gray ? 0 : s * 100);
+    ls[i] = jsRound(l * 100);
+  }
+
+  if (slow) {
+    for (std::size_t i = 0; i < m; i++) {
+      if (blk.r[i] == blk.r[i] && blk.g[i] == blk.g[i] && blk.b[i] == blk.b[i]) continue;
+      rgbToHslScalar(blk.r[i], blk.g[i], blk.b[i], hs[i], ss[i], ls[i]);
+    }
+  }
+  std::copy_n(hs, m, blk.r);
+  std::copy_n(ss, m, blk.g);
+  std::copy_n(ls, m, blk.b);
+}
+
+// ---- Element access --------------------------------------------------------
+
+template <typename T>
+inline constexpr bool kIsBytes = std::is_same_v<T, std::uint8_t>;
+
+// ToUint8Clamp for Uint8ClampedArray, plain conversion for float arrays.
+template <typename T>
+inline T store(double v) {
+  if constexpr (kIsBytes<T>) {
+    if (!(v > 0)) return 0;
+    if (v >= 255) return 255;
+    return static_cast<T>(std::nearbyint(v));
+  } else {
+    return static_cast<T>(v);
+  }
+}
+
+// Decode m colors of `in` into blk as integer-or-clamped RGB plus alpha.
+template <typename In>
+inline void decode(const In* in, std::size_t m, Format from, Block& blk) {
+  for (std::size_t i = 0; i < m; i++) {
+    blk.r[i] = static_cast<double>(in[i * 4]);
+    blk.g[i] = static_cast<double>(in[i * 4 + 1]);
+    blk.b[i] = static_cast<double>(in[i * 4 + 2]);
+    const double a = static_cast<double>(in[i * 4 + 3]);
+    blk.a[i] = kIsBytes<In> ? a / 255 : a;
+  }
+  switch (from) {
+    case Format::Hsla:
+      hslToRgbBlock(blk, m);
+      break;
+    case Format::UnitRgba:
+      for (std::size_t i = 0; i < m; i++) {
+        blk.r[i] = jsUnitTo255(blk.r[i]);
+        blk.g[i] = jsUnitTo255(blk.g[i]);
+        blk.b[i] = jsUnitTo255(blk.b[i]);
+      }
+      break;
+    case Format::Rgba:
+      for (std::size_t i = 0; i < m; i++) {
+        blk.r[i] = jsClamp255(blk.r[i]);
+        blk.g[i] = jsClamp255(blk.g[i]);
+        blk.b[i] = jsClamp255(blk.b[i]);
+      }
+      break;
+  }
+}
+
+// Encode m RGB colors of blk into `out` in format `to`. Clobbers blk.
+template <typename Out>
+inline void encode(Block& blk, std::size_t m, Format to, Out* out) {
+  switch (to) {
+    case Format::Hsla:
+      rgbToHslBlock(blk, m);
+      break;
+    case Format::UnitRgba:
+      for (std::size_t i = 0; i < m; i++) {
+        blk.r[i] /= 255;
+        blk.g[i] /= 255;
+        blk.b[i] /= 255;
+      }
+      break;
+    case Format::Rgba:
+      if constexpr (kIsBytes<Out>) {
+        for (std::size_t i = 0; i < m; i++) blk.a[i] *= 255;
+      }
+      break;
+  }
+  for (std::size_t i = 0; i < m; i++) {
+    out[i * 4] = store<Out>(blk.r[i]);
+    out[i * 4 + 1] = store<Out>(blk.g[i]);
+    out[i * 4 + 2] = store<Out>(blk.b[i]);
+    out[i * 4 + 3] = store<Out>(blk.a[i]);
+  }
+}
+
+// Convert min(inLength, outLength) / 4 colors. `in` and `out` may alias.
+template <typename In, typename Out>
+inline std::size_t convert(const In* in, std::size_t inLength, Out* out, std::size_t outLength,
+                           Format from, Format to) {
+  const std::size_t n = std::min(inLength, outLength) / 4;
+  Block blk;
+  for (std::size_t base = 0; base < n; base += kLanes) {
+    const std::size_t m = std::min(kLanes, n - base);
+    decode(in + base * 4, m, from, blk);
+    encode(blk, m, to, out + base * 4);
+  }
+  return n;
+}
+
+#if defined(BRIKLAB_X86_TARGETS)
+// convert() recompiled for wider vectors. flatten inlines the block kernels
+// so they are generated for the target; FMA is left out so results stay
+// bit-identical to the scalar build (and to JS).
+template <typename In, typename Out>
+BRIKLAB_TARGET("avx2") __attribute__((flatten)) std::size_t convertAvx2(
+    const In* in, std::size_t inLength, Out* out, std::size_t outLength, Format from, Format to) {
+  return convert(in, inLength, out, outLength, from, to);
+}
+
+template <typename In, typename Out>
+BRIKLAB_TARGET("sse4.2") __attribute__((flatten)) std::size_t convertSse42(
+    const In* in, std::size_t inLength, Out* out, std::size_t outLength, Format from, Format to) {
+  return convert(in, inLength, out, outLength, from, to);
+}
+#endif
+
+// convert() in the flavor cpu::isa() picked. On arm64 the baseline build
+// already uses NEON.
+template <typename In, typename Out>
+inline std::size_t convertDispatch(const In* in, std::size_t inLength, Out* out,
+                                   std::size_t outLength, Format from, Format to) {
+#if defined(BRIKLAB_X86_TARGETS)
+  switch (cpu::isa()) {
+    case cpu::Isa::Avx2:
+      return convertAvx2(in, inLength, out, outLength, from, to);
+    case cpu::Isa::Sse42:
+      return convertSse42(in, inLength, out, outLength, from, to);
+    default:
+      break;
+  }
+#endif
+  return convert(in, inLength, out, outLength, from, to);
+}
+
+// Write one parsed color to color index `i` of `out`.
+template <typename Out>
+inline void write(const Rgba& c, Out* out, std::size_t i, Format to) {
+  Block blk;
+  blk.r[0] = c.r;
+  blk.g[0] = c.g;
+  blk.b[0] = c.b;
+  blk.a[0] = c.a;
+  encode(blk, 1, to, out + i * 4);
+}
+
+}  // namespace briklab::color
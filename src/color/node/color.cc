@@ -0,0 +1,254 @@
+// Node-API kernels of the color module.
+//
+// Linked into the briklab_core addon (src/native/binding.gyp), which exposes
+// them as `core.color`.
+
+#include <node_api.h>
+
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "core.hpp"
+#include "napi_util.hpp"
+#include "palette.hpp"
+#include "parse.hpp"
+
+namespace {
+
+using briklab::napi::readString;
+using briklab::napi::TypedView;
+using briklab::napi::typedView;
+
+// Optional Float64Array argument; returns nullptr when absent or not one.
+double* float64Data(napi_env env, napi_value value, size_t& length) {
+  TypedView view;
+  if (!typedView(env, value, view) || view.type != napi_float64_array) return nullptr;
+  length = view.length;
+  return static_cast<double*>(view.data);
+}
+
+// parse(input: string, alphaOut?: Float64Array): number
+// Returns packed 0xRRGGBBAA, or -1 when the string should go through the TS
+// parser. The unquantized alpha is written to alphaOut[0].
+napi_value Parse(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  napi_value result;
+  thread_local std::string input;
+  briklab::color::Rgba rgba;
+  if (argc < 1 || !readString(env, argv[0], input) || !briklab::color::parse(input, rgba)) {
+    BRIKLAB_CALL(env, napi_create_int32(env, -1, &result));
+    return result;
+  }
+
+  if (argc >= 2) {
+    size_t length = 0;
+    if (double* alpha = float64Data(env, argv[1], length); alpha && length > 0) alpha[0] = rgba.a;
+  }
+  BRIKLAB_CALL(env, napi_create_uint32(env, briklab::color::pack(rgba), &result));
+  return result;
+}
+
+// Typed array accepted by the batch functions.
+bool batchView(napi_env env, napi_value value, TypedView& view) {
+  if (!typedView(env, value, view)) return false;
+  return view.type == napi_float32_array || view.type == napi_float64_array ||
+         view.type == napi_uint8_clamped_array;
+}
+
+bool batchFormat(napi_env env, napi_value value, briklab::color::Format& format) {
+  int32_t code = -1;
+  if (napi_get_value_int32(env, value, &code) != napi_ok || code < 0 || code > 2) return false;
+  format = static_cast<briklab::color::Format>(code);
+  return true;
+}
+
+// Calls fn with `data` cast to the element type of the view.
+template <typename Fn>
+void withElements(const TypedView& view, Fn&& fn) {
+  switch (view.type) {
+    case napi_float32_array:
+      fn(static_cast<float*>(view.data));
+      break;
+    case napi_float64_array:
+      fn(static_cast<double*>(view.data));
+      break;
+    default:
+      fn(static_cast<uint8_t*>(view.data));
+      break;
+  }
+}
+
+// parseMany(inputs: unknown[], out: ColorBatchArray, format: number): number[]
+// Writes every color it can parse and returns the indices left to the TS path.
+napi_value ParseMany(napi_env env, napi_callback_info info) {
+  size_t argc = 3;
+  napi_value argv[3];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  TypedView out;
+  briklab::color::Format to;
+  bool isArray = false;
+  if (argc < 3 || napi_is_array(env, argv[0], &isArray) != napi_ok || !isArray ||
+      !batchView(env, argv[1], out) || !batchFormat(env, argv[2], to)) {
+    napi_throw_type_error(env, nullptr, "@briklab/lib/color: parseMany(inputs, out, format)");
+    return nullptr;
+  }
+
+  uint32_t length = 0;
+  BRIKLAB_CALL(env, napi_get_array_length(env, argv[0], &length));
+  const size_t n = std::min<size_t>(length, out.length / 4);
+
+  std::vector<uint32_t> declined;
+  std::string input;
+  briklab::color::Rgba rgba;
+  for (size_t i = 0; i < n; i++) {
+    napi_value item;
+    BRIKLAB_CALL(env, napi_get_element(env, argv[0], static_cast<uint32_t>(i), &item));
+    if (!readString(env, item, input) || !briklab::color::parse(input, rgba)) {
+      declined.push_back(static_cast<uint32_t>(i));
+      continue;
+    }
+    withElements(out, [&](auto* data) { briklab::color::write(rgba, data, i, to); });
+  }
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_create_array_with_length(env, declined.size(), &result));
+  for (size_t k = 0; k < declined.size(); k++) {
+    napi_value index;
+    BRIKLAB_CALL(env, napi_create_uint32(env, declined[k], &index));
+    BRIKLAB_CALL(env, napi_set_element(env, result, static_cast<uint32_t>(k), index));
+  }
+  return result;
+}
+
+// convertMany(input: ColorBatchArray, from: number, out: ColorBatchArray, to: number): number
+napi_value ConvertMany(napi_env env, napi_callback_info info) {
+  size_t argc = 4;
+  napi_value argv[4];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  TypedView in, out;
+  briklab::color::Format from, to;
+  if (argc < 4 || !batchView(env, argv[0], in) || !batchFormat(env, argv[1], from) ||
+      !batchView(env, argv[2], out) || !batchFormat(env, argv[3], to)) {
+    napi_throw_type_error(env, nullptr, "@briklab/lib/color: convertMany(input, from, out, to)");
+    return nullptr;
+  }
+
+  size_t n = 0;
+  withElements(in, [&](auto* src) {
+    withElements(out, [&](auto* dst) {
+      n = briklab::color::convertDispatch(src, in.length, dst, out.length, from, to);
+    });
+  });
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_create_uint32(env, static_cast<uint32_t>(n), &result));
+  return result;
+}
+
+// ColorBuffer memory: the Uint8Array over a whole buffer of `length` colors.
+bool paletteView(napi_env env, napi_value bytes, napi_value length, briklab::color::palette::Planes& out,
+                 uint32_t& n) {
+  TypedView view;
+  if (!typedView(env, bytes, view) || view.type != napi_uint8_array) return false;
+  if (napi_get_value_uint32(env, length, &n) != napi_ok) return false;
+  if (view.length < briklab::color::palette::byteLength(n)) return false;
+  out = briklab::color::palette::planes(static_cast<uint8_t*>(view.data), n);
+  return true;
+}
+
+// paletteLighten(bytes, length, t, target, outBytes, outLength): undefined
+napi_value PaletteLighten(napi_env env, napi_callback_info info) {
+  size_t argc = 6;
+  napi_value argv[6];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  briklab::color::palette::Planes in, out;
+  uint32_t n = 0, outLength = 0;
+  double t = 0, target = 0;
+  if (argc < 6 || !paletteView(env, argv[0], argv[1], in, n) ||
+      napi_get_value_double(env, argv[2], &t) != napi_ok ||
+      napi_get_value_double(env, argv[3], &target) != napi_ok ||
+      !paletteView(env, argv[4], argv[5], out, outLength) || outLength < n) {
+    napi_throw_type_error(env, nullptr,
+                          "@briklab/lib/color: paletteLighten(bytes, length, t, target, outBytes, outLength)");
+    return nullptr;
+  }
+  briklab::color::palette::lightenDispatch(in, out, n, t, target);
+  return nullptr;
+}
+
+// paletteMix(bytes, length, otherBytes, otherLength, weight, outBytes, outLength): undefined
+// An `otherLength` of 1 mixes every entry with that one color.
+napi_value PaletteMix(napi_env env, napi_callback_info info) {
+  size_t argc = 7;
+  napi_value argv[7];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  briklab::color::palette::Planes in, other, out;
+  uint32_t n = 0, otherLength = 0, outLength = 0;
+  double w = 0;
+  if (argc < 7 || !paletteView(env, argv[0], argv[1], in, n) ||
+      !paletteView(env, argv[2], argv[3], other, otherLength) ||
+      napi_get_value_double(env, argv[4], &w) != napi_ok ||
+      !paletteView(env, argv[5], argv[6], out, outLength) || outLength < n ||
+      (otherLength != 1 && otherLength < n)) {
+    napi_throw_type_error(
+        env, nullptr,
+        "@briklab/lib/color: paletteMix(bytes, length, otherBytes, otherLength, weight, outBytes, outLength)");
+    return nullptr;
+  }
+  briklab::color::palette::mixDispatch(in, other, otherLength == 1, out, n, w);
+  return nullptr;
+}
+
+// paletteContrast(bytes, length, otherBytes, otherLength, linear: Float64Array(256), out: Float32Array): undefined
+napi_value PaletteContrast(napi_env env, napi_callback_info info) {
+  size_t argc = 6;
+  napi_value argv[6];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  briklab::color::palette::Planes in, other;
+  uint32_t n = 0, otherLength = 0;
+  size_t linearLength = 0;
+  const double* linear = argc >= 6 ? float64Data(env, argv[4], linearLength) : nullptr;
+  TypedView out;
+  if (argc < 6 || !paletteView(env, argv[0], argv[1], in, n) ||
+      !paletteView(env, argv[2], argv[3], other, otherLength) || (otherLength != 1 && otherLength < n) ||
+      otherLength == 0 || !linear || linearLength < 256 || !typedView(env, argv[5], out) ||
+      out.type != napi_float32_array || out.length < n) {
+    napi_throw_type_error(
+        env, nullptr,
+        "@briklab/lib/color: paletteContrast(bytes, length, otherBytes, otherLength, linear, out)");
+    return nullptr;
+  }
+  briklab::color::palette::contrastDispatch(in, other, otherLength == 1, n, linear,
+                                            static_cast<float*>(out.data));
+  return nullptr;
+}
+
+}  // namespace
+
+namespace briklab::color {
+
+napi_value Init(napi_env env, napi_value exports) {
+  BRIKLAB_CALL(env, briklab::napi::exportAbiVersion(env, exports));
+
+  napi_property_descriptor props[] = {
+      {"parse", nullptr, Parse, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"parseMany", nullptr, ParseMany, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"convertMany", nullptr, ConvertMany, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"paletteLighten", nullptr, PaletteLighten, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"paletteMix", nullptr, PaletteMix, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"paletteContrast", nullptr, PaletteContrast, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+  };
+  BRIKLAB_CALL(env, napi_define_properties(env, exports, sizeof(props) / sizeof(*props), props));
+  return exports;
+}
+
+}  // namespace briklab::color
@@ -0,0 +1,59 @@
+/**
+ * # @briklab/lib/color/node
+ * Typed access to the optional native color addon.
+ * `native` is `null` when the addon is not built or cannot be loaded.
+ */
+
+import type { ColorBatchArray } from "../index.js";
+
+export interface ColorNativeAddon {
+  abiVersion: number;
+  /**
+   * Parse a CSS color string in one pass.
+   * Returns packed `0xRRGGBBAA` (alpha quantized to 8 bits) or `-1` when the
+   * string must go through the TS parser. The exact alpha is written to
+   * `alphaOut[0]` when given.
+   */
+  parse(input: string, alphaOut?: Float64Array): number;
+  /**
+   * Parse `inputs` into `out` (batch format code, see `Color.parseMany`).
+   * Returns the indices it could not parse, for the TS path to handle.
+   */
+  parseMany(inputs: readonly unknown[], out: ColorBatchArray, format: number): number[];
+  /**
+   * Convert between batch format codes. Returns the number of colors written.
+   */
+  convertMany(input: ColorBatchArray, from: number, out: ColorBatchArray, to: number): number;
+  /**
+   * ColorBuffer kernels. `bytes` spans a whole ColorBuffer of `length`
+   * colors (layout in src/color/node/palette.hpp). An `otherLength` of 1
+   * applies that one color to every entry.
+   */
+  paletteLighten(
+    bytes: Uint8Array,
+    length: number,
+    t: number,
+    target: number,
+    outBytes: Uint8Array,
+    outLength: number,
+  ): void;
+  paletteMix(
+    bytes: Uint8Array,
+    length: number,
+    otherBytes: Uint8Array,
+    otherLength: number,
+    weight: number,
+    outBytes: Uint8Array,
+    outLength: number,
+  ): void;
+  paletteContrast(
+    bytes: Uint8Array,
+    length: number,
+    otherBytes: Uint8Array,
+    otherLength: number,
+    linear: Float64Array,
+    out: Float32Array,
+  ): void;
+}
+
+export { native } from "../index.js";
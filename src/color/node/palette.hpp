@@ -0,0 +1,177 @@
+// Bulk kernels behind ColorBuffer (src/color/buffer.ts).
+//
+// A ColorBuffer of n colors is one block of memory: r, g and b planes of n
+// bytes each, padding to a multiple of 4, then n float32 alphas. Each kernel
+// is a plain loop over those planes, which the compiler vectorizes, and
+// uses the same double arithmetic as the TS loops so both produce identical
+// buffers. The AVX2 and SSE4.2 variants are the same loops recompiled.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "cpu.hpp"
+#include "parse.hpp"
+
+namespace briklab::color::palette {
+
+// Keep in sync with alphaOffset() in src/color/buffer.ts.
+inline std::size_t alphaOffset(std::size_t n) { return (3 * n + 3) & ~std::size_t{3}; }
+inline std::size_t byteLength(std::size_t n) { return alphaOffset(n) + 4 * n; }
+
+struct Planes {
+  std::uint8_t* r;
+  std::uint8_t* g;
+  std::uint8_t* b;
+  float* a;
+};
+
+inline Planes planes(std::uint8_t* base, std::size_t n) {
+  return {base, base + n, base + 2 * n, reinterpret_cast<float*>(base + alphaOffset(n))};
+}
+
+// Math.round of a value already in [0, 255], stored as a byte. Same
+// result as jsRound(); for v >= 0 truncation is floor, and unlike
+// std::floor it vectorizes on every x86 target.
+inline std::uint8_t toByte(double v) {
+  const int k = static_cast<int>(v);
+  return static_cast<std::uint8_t>(k + (v - k >= 0.5));
+}
+
+// out = in + (target - in) * t per color channel; alpha is copied.
+inline void lighten(const Planes& in, const Planes& out, std::size_t n, double t, double target) {
+  std::uint8_t* const src[3] = {in.r, in.g, in.b};
+  std::uint8_t* const dst[3] = {out.r, out.g, out.b};
+  for (int c = 0; c < 3; c++) {
+    const std::uint8_t* s = src[c];
+    std::uint8_t* d = dst[c];
+    for (std::size_t i = 0; i < n; i++) d[i] = toByte(s[i] + (target - s[i]) * t);
+  }
+  if (out.a != in.a) {
+    for (std::size_t i = 0; i < n; i++) out.a[i] = in.a[i];
+  }
+}
+
+// out = in + (other - in) * w for every channel, alpha included. `other`
+// holds one color per entry, or a single color when `broadcast` is set.
+inline void mix(const Planes& in, const Planes& other, bool broadcast, const Planes& out,
+                std::size_t n, double w) {
+  std::uint8_t* const src[3] = {in.r, in.g, in.b};
+  std::uint8_t* const with[3] = {other.r, other.g, other.b};
+  std::uint8_t* const dst[3] = {out.r, out.g, out.b};
+  for (int c = 0; c < 3; c++) {
+    const std::uint8_t* s = src[c];
+    const std::uint8_t* o = with[c];
+    std::uint8_t* d = dst[c];
+    if (broadcast) {
+      const double y = o[0];
+      for (std::size_t i = 0; i < n; i++) d[i] = toByte(s[i] + (y - s[i]) * w);
+    } else {
+      for (std::size_t i = 0; i < n; i++) d[i] = toByte(s[i] + (static_cast<double>(o[i]) - s[i]) * w);
+    }
+  }
+  if (broadcast) {
+    const double y = other.a[0];
+    for (std::size_t i = 0; i < n; i++) out.a[i] = static_cast<float>(in.a[i] + (y - in.a[i]) * w);
+  } else {
+    for (std::size_t i = 0; i < n; i++) {
+      out.a[i] = static_cast<float>(in.a[i] + (static_cast<double>(other.a[i]) - in.a[i]) * w);
+    }
+  }
+}
+
+// WCAG contrast ratio of every color against `other`. `linear` maps a
+// channel byte to linear light; it comes from the TS side so both paths
+// share the exact same table.
+inline void contrast(const Planes& in, const Planes& other, bool broadcast, std::size_t n,
+                     const double* linear, float* out) {
+  auto luminance = [linear](std::uint8_t r, std::uint8_t g, std::uint8_t b) {
+    return 0.2126 * linear[r] + 0.7152 * linear[g] + 0.0722 * linear[b];
+  };
+  const double fixed = luminance(other.r[0], other.g[0], other.b[0]);
+  for (std::size_t i = 0; i < n; i++) {
+    const double x = luminance(in.r[i], in.g[i], in.b[i]);
+    const double y = broadcast ? fixed : luminance(other.r[i], other.g[i], other.b[i]);
+    out[i] = static_cast<float>(x > y ? (x + 0.05) / (y + 0.05) : (y + 0.05) / (x + 0.05));
+  }
+}
+
+#if defined(BRIKLAB_X86_TARGETS)
+// FMA stays disabled in these variants, so results match the baseline build.
+BRIKLAB_TARGET("avx2") __attribute__((flatten)) inline void lightenAvx2(
+    const Planes& in, const Planes& out, std::size_t n, double t, double target) {
+  lighten(in, out, n, t, target);
+}
+BRIKLAB_TARGET("sse4.2") __attribute__((flatten)) inline void lightenSse42(
+    const Planes& in, const Planes& out, std::size_t n, double t, double target) {
+  lighten(in, out, n, t, target);
+}
+BRIKLAB_TARGET("avx2") __attribute__((flatten)) inline void mixAvx2(
+    const Planes& in, const Planes& other, bool broadcast, const Planes& out, std::size_t n,
+    double w) {
+  mix(in, other, broadcast, out, n, w);
+}
+BRIKLAB_TARGET("sse4.2") __attribute__((flatten)) inline void mixSse42(
+    const Planes& in, const Planes& other, bool broadcast, const Planes& out, std::size_t n,
+    double w) {
+  mix(in, other, broadcast, out, n, w);
+}
+BRIKLAB_TARGET("avx2") __attribute__((flatten)) inline void contrastAvx2(
+    const Planes& in, const Planes& other, bool broadcast, std::size_t n, const double* linear,
+    float* out) {
+  contrast(in, other, broadcast, n, linear, out);
+}
+BRIKLAB_TARGET("sse4.2") __attribute__((flatten)) inline void contrastSse42(
+    const Planes& in, const Planes& other, bool broadcast, std::size_t n, const double* linear,
+    float* out) {
+  contrast(in, other, broadcast, n, linear, out);
+}
+#endif
+
+inline void lightenDispatch(const Planes& in, const Planes& out, std::size_t n, double t,
+                            double target) {
+#if defined(BRIKLAB_X86_TARGETS)
+  switch (cpu::isa()) {
+    case cpu::Isa::Avx2:
+      return lightenAvx2(in, out, n, t, target);
+    case cpu::Isa::Sse42:
+      return lightenSse42(in, out, n, t, target);
+    default:
+      break;
+  }
+#endif
+  lighten(in, out, n, t, target);
+}
+
+inline void mixDispatch(const Planes& in, const Planes& other, bool broadcast, const Planes& out,
+                        std::size_t n, double w) {
+#if defined(BRIKLAB_X86_TARGETS)
+  switch (cpu::isa()) {
+    case cpu::Isa::Avx2:
+      return mixAvx2(in, other, broadcast, out, n, w);
+    case cpu::Isa::Sse42:
+      return mixSse42(in, other, broadcast, out, n, w);
+    default:
+      break;
+  }
+#endif
+  mix(in, other, broadcast, out, n, w);
+}
+
+inline void contrastDispatch(const Planes& in, const Planes& other, bool broadcast, std::size_t n,
+                             const double* linear, float* out) {
+#if defined(BRIKLAB_X86_TARGETS)
+  switch (cpu::isa()) {
+    case cpu::Isa::Avx2:
+      return contrastAvx2(in, other, broadcast, n, linear, out);
+    case cpu::Isa::Sse42:
+      return contrastSse42(in, other, broadcast, n, linear, out);
+    default:
+      break;
+  }
+#endif
+  contrast(in, other, broadcast, n, linear, out);
+}
+
+}  // namespace briklab::color::palette
@@ -0,0 +1,234 @@
+// Single-pass CSS color string parser used by the color addon.
+//
+// Mirrors Color#parseString in src/color/index.ts for well-formed input:
+// hex (#rgb, #rgba, #rrggbb, #rrggbbaa), rgb()/rgba(), hsl()/hsla(), the
+// CSS named colors (named.hpp) and "transparent". Anything the parser is not sure about
+// (non-ASCII, lenient parseFloat suffixes, malformed input) is reported as
+// unparsed so the TS path can apply its exact fallback and warning rules.
+
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "named.hpp"
+
+namespace briklab::color {
+
+struct Rgba {
+  double r = 0;
+  double g = 0;
+  double b = 0;
+  double a = 1;
+};
+
+inline constexpr std::size_t kMaxInputLength = 256;
+
+// Math.round: nearest integer, ties towards +infinity.
+inline double jsRound(double x) {
+  const double f = std::floor(x);
+  return (x - f >= 0.5) ? f + 1 : f;
+}
+
+inline double clamp(double v, double lo, double hi) { return std::max(lo, std::min(hi, v)); }
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+inline std::string_view trim(std::string_view s) {
+  while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+  while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+  return s;
+}
+
+// Strict parseFloat: the whole token must be a number.
+inline bool parseNumber(std::string_view t, double& out) {
+  if (!t.empty() && t.front() == '+') t.remove_prefix(1);
+  if (t.empty()) return false;
+  const char first = t.front() == '-' && t.size() > 1 ? t[1] : t.front();
+  if (!((first >= '0' && first <= '9') || first == '.')) return false;
+  const char* end = t.data() + t.size();
+  auto [ptr, ec] = std::from_chars(t.data(), end, out);
+  return ec == std::errc() && ptr == end;
+}
+
+inline bool parsePercentSuffixed(std::string_view t, double& out, bool& percent) {
+  percent = !t.empty() && t.back() == '%';
+  if (percent) t.remove_suffix(1);
+  return parseNumber(t, out);
+}
+
+inline bool parseRgbComponent(std::string_view t, double& out) {
+  double v;
+  bool percent;
+  if (!parsePercentSuffixed(t, v, percent)) return false;
+  if (percent) {
+    out = clamp(jsRound((v / 100) * 255), 0, 255);
+  } else if (v >= 0 && v <= 1) {
+    out = clamp(jsRound(v * 255), 0, 255);
+  } else {
+    out = clamp(jsRound(v), 0, 255);
+  }
+  return true;
+}
+
+inline bool parseAlpha(std::string_view t, double& out) {
+  double v;
+  bool percent;
+  if (!parsePercentSuffixed(t, v, percent)) return false;
+  out = clamp(percent ? v / 100 : v, 0, 1);
+  return true;
+}
+
+inline bool parseHue(std::string_view t, double& out) {
+  if (t.size() >= 3 && t.substr(t.size() - 3) == "deg") t.remove_suffix(3);
+  double v;
+  if (!parseNumber(t, v)) return false;
+  out = std::fmod(std::fmod(v, 360) + 360, 360);
+  return true;
+}
+
+inline bool parsePercentage(std::string_view t, double& out) {
+  double v;
+  bool percent;
+  if (!parsePercentSuffixed(t, v, percent)) return false;
+  out = clamp(v, 0, 100);
+  return true;
+}
+
+// Same arithmetic as Color#hslToRgb so both paths round identically.
+inline void hslToRgb(double h, double s, double l, Rgba& out) {
+  s /= 100;
+  l /= 100;
+  const double a = s * std::min(l, 1 - l);
+  auto f = [&](double n) {
+    const double k = std::fmod(n + h / 30, 12);
+    return l - a * std::max(-1.0, std::min(k - 3, std::min(9 - k, 1.0)));
+  };
+  out.r = jsRound(f(0) * 255);
+  out.g = jsRound(f(8) * 255);
+  out.b = jsRound(f(4) * 255);
+}
+
+// `hex` holds 3, 4, 6 or 8 digits (checked by the caller).
+inline bool parseHex(std::string_view hex, Rgba& out) {
+  int d[8] = {};
+  for (std::size_t i = 0; i < hex.size(); i++) {
+    d[i] = hexDigit(hex[i]);
+    if (d[i] < 0) return false;
+  }
+  if (hex.size() == 3 || hex.size() == 4) {
+    out.r = d[0] * 17;
+    out.g = d[1] * 17;
+    out.b = d[2] * 17;
+    if (hex.size() == 4) out.a = (d[3] * 17) / 255.0;
+    return true;
+  }
+  out.r = d[0] * 16 + d[1];
+  out.g = d[2] * 16 + d[3];
+  out.b = d[4] * 16 + d[5];
+  if (hex.size() == 8) out.a = (d[6] * 16 + d[7]) / 255.0;
+  return true;
+}
+
+// rgb(...) / hsl(...) body: color tokens separated by whitespace or commas,
+// optional "/ alpha".
+inline bool parseFunctional(std::string_view s, bool hsl, Rgba& out) {
+  const std::size_t open = s.find('(');
+  if (open == std::string_view::npos || s.back() != ')') return false;
+  std::string_view body = s.substr(open + 1, s.size() - open - 2);
+
+  std::string_view colorPart = body;
+  std::string_view alphaPart;
+  bool hasSlash = false;
+  if (const std::size_t slash = body.find('/'); slash != std::string_view::npos) {
+    hasSlash = true;
+    colorPart = body.substr(0, slash);
+    alphaPart = body.substr(slash + 1);
+    alphaPart = trim(alphaPart.substr(0, alphaPart.find('/')));
+  }
+
+  std::string_view parts[4];
+  std::size_t count = 0;
+  std::size_t i = 0;
+  while (i < colorPart.size()) {
+    while (i < colorPart.size() && (isSpace(colorPart[i]) || colorPart[i] == ',')) i++;
+    const std::size_t start = i;
+    while (i < colorPart.size() && !(isSpace(colorPart[i]) || colorPart[i] == ',')) i++;
+    if (i > start) {
+      if (count < 4) parts[count] = colorPart.substr(start, i - start);
+      count++;
+    }
+  }
+  if (count < 3) return false;
+
+  if (hsl) {
+    double h, sat, light;
+    if (!parseHue(parts[0], h) || !parsePercentage(parts[1], sat) || !parsePercentage(parts[2], light))
+      return false;
+    hslToRgb(h, sat, light, out);
+  } else {
+    if (!parseRgbComponent(parts[0], out.r) || !parseRgbComponent(parts[1], out.g) ||
+        !parseRgbComponent(parts[2], out.b))
+      return false;
+  }
+
+  if (hasSlash) return parseAlpha(alphaPart, out.a);
+  if (count >= 4) return parseAlpha(parts[3], out.a);
+  return true;
+}
+
+// Parse a CSS color string. Returns false when the TS path should handle it.
+inline bool parse(std::string_view input, Rgba& out) {
+  out = Rgba{};
+  if (input.size() > kMaxInputLength) return false;
+
+  char buf[kMaxInputLength];
+  std::size_t n = 0;
+  for (char c : input) {
+    if (static_cast<unsigned char>(c) >= 0x80 || c == '\0') return false;
+    buf[n++] = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+  }
+  std::string_view s = trim(std::string_view(buf, n));
+  if (s.empty()) return false;
+
+  if (s == "transparent") {
+    out.a = 0;
+    return true;
+  }
+  if (const named::NamedColor* named = named::find(s)) {
+    out.r = named->rgb >> 16;
+    out.g = (named->rgb >> 8) & 0xff;
+    out.b = named->rgb & 0xff;
+    return true;
+  }
+
+  if (s.front() == '#') {
+    const std::string_view hex = s.substr(1);
+    if (hex.size() != 3 && hex.size() != 4 && hex.size() != 6 && hex.size() != 8) return false;
+    return parseHex(hex, out);
+  }
+  if (s.substr(0, 3) == "rgb") return parseFunctional(s, false, out);
+  if (s.substr(0, 3) == "hsl") return parseFunctional(s, true, out);
+  return false;
+}
+
+// 0xRRGGBBAA with the alpha channel quantized to 8 bits.
+inline std::uint32_t pack(const Rgba& c) {
+  const auto channel = [](double v) { return static_cast<std::uint32_t>(clamp(v, 0, 255)); };
+  return channel(c.r) << 24 | channel(c.g) << 16 | channel(c.b) << 8 |
+         channel(jsRound(c.a * 255));
+}
+
+}  // namespace briklab::color
@@ -2,4 +2,5 @@
  * @packageDocumentation
  * The main library for briklab packages
  */
-export { warner, createWarner, default as Warner } from "./warner/index.js";
\ No newline at end of file
+export { warner, createWarner, default as Warner, OutputSink, getOutputSink } from "./warner/index.js";
+export { nativeInfo } from "./native/load.js";
\ No newline at end of file
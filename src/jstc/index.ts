@@ -7,9 +7,23 @@
 
 import { createWarner } from "../warner/index.js";
 import { loadNativeAddon } from "../native/load.js";
+import type { JSTCNativeAddon } from "./node/index.js";
 
 const jstcWarner = createWarner("@briklab/lib/jstc");
-export const native = loadNativeAddon(import.meta.url, "jstc");
+export const native = loadNativeAddon("jstc") as JSTCNativeAddon | null;
+
+/**
+ * Minimum argument count before a primitive-only compiled checker is handed to
+ * `native.checkPrimitives`. Every argument costs the addon one N-API element
+ * read, which `bench/jstc-native-crossover.mjs` measured slower than the JS
+ * loop at every width, so routing is off unless BRIKLAB_JSTC_NATIVE_MIN_ARGS is set.
+ */
+const NATIVE_PRIMITIVE_MIN_ARGS = minArgsFromEnv(globalThis.process?.env?.BRIKLAB_JSTC_NATIVE_MIN_ARGS);
+
+/** A positive integer; anything else (unset, "", "0", "abc", "1.5") keeps routing off. */
+function minArgsFromEnv(value: string | undefined): number {
+  return value !== undefined && /^[1-9][0-9]*$/.test(value.trim()) ? Number(value) : Infinity;
+}
 
 /**
  * # Protection Level
@@ -74,6 +88,70 @@ function createJSTCError(scope: string, message: string, hint?: string, otherMes
   return new Error(formatJSTCMessage(scope, message, hint, otherMessage));
 }
 
+/**
+ * # Compiled Checker
+ * A reusable predicate returned by `JSTC.compile`.
+ */
+export type CompiledChecker = (...args: unknown[]) => boolean;
+
+type ValueTest = (value: unknown) => boolean;
+
+/**
+ * Parsed form of a type list, re-resolved when custom handlers change.
+ */
+interface CompiledSchema {
+  unions: JSType[][];
+  count: number;
+  tests: ValueTest[];
+  /** typeof bitmask per argument, null unless every alternative is a primitive name. */
+  masks: Uint8Array | null;
+  version: number;
+}
+
+/** Schemas behind the checkers returned by `compile`, for `checkAll`. */
+const compiledSchemas = new WeakMap<CompiledChecker, CompiledSchema>();
+
+export interface CheckAllOptions {
+  /** Stop after the first failing row. */
+  stopOnFirst?: boolean;
+}
+
+export interface CheckAllResult {
+  /** 1 for every row that passed, 0 otherwise (including unchecked rows). */
+  passed: Uint8Array;
+  /** First failing column per row, -1 for passing or unchecked rows and when unknown. */
+  failedColumn: Int32Array;
+  /** Number of failing rows. */
+  failures: number;
+  /** Number of rows checked; less than rows.length only with stopOnFirst. */
+  checked: number;
+}
+
+/** Shared `typeof` tests so compiled checkers reuse the same closures. */
+const TYPEOF_TESTS: Record<PrimitiveType, ValueTest> = {
+  string: (value) => typeof value === "string",
+  number: (value) => typeof value === "number",
+  boolean: (value) => typeof value === "boolean",
+  object: (value) => typeof value === "object",
+  function: (value) => typeof value === "function",
+  undefined: (value) => typeof value === "undefined",
+  symbol: (value) => typeof value === "symbol",
+  bigint: (value) => typeof value === "bigint",
+};
+const NEVER: ValueTest = () => false;
+
+/** `typeof` result bits used by `native.checkPrimitives` masks. */
+export const TYPEOF_BITS: Record<PrimitiveType, number> = {
+  string: 1 << 0,
+  number: 1 << 1,
+  boolean: 1 << 2,
+  object: 1 << 3,
+  function: 1 << 4,
+  undefined: 1 << 5,
+  symbol: 1 << 6,
+  bigint: 1 << 7,
+};
+
 /**
  * # JSTypeChecker
  * A JS Type Checker. Add type checking to your javascript files as well
@@ -86,6 +164,8 @@ export class JSTypeChecker {
   };
   #protectionLevel: ProtectionLevel = "boundary";
   #frozenHandlers = false;
+  /** Bumped by addCustomHandler so compiled checkers re-resolve their handlers. */
+  #handlerVersion = 0;
 
   /**
    * ### JSTypeChecker.setProtectionLevel
@@ -166,6 +246,198 @@ export class JSTypeChecker {
     };
   }
 
+  /**
+   * ### JSTypeChecker.compile
+   * Compile a type list once and get a reusable checker.
+   * Unions are split and custom handlers resolved up front, so each call only
+   * runs one test per argument.
+   * @example
+   * const isNameAndStyle = JSTC.compile(["string", "object|undefined"]);
+   * isNameAndStyle("a", {}); // true
+   */
+  compile(types: JSTypeOrArray[]): CompiledChecker {
+    const schema = this.#createSchema(types, "JSTC.compile");
+    const count = schema.count;
+
+    const checker: CompiledChecker = (...args: unknown[]): boolean => {
+      if (schema.version !== this.#handlerVersion) this.#resolveSchema(schema);
+      const masks = schema.masks;
+      if (masks !== null && native && count >= NATIVE_PRIMITIVE_MIN_ARGS) {
+        return native.checkPrimitives(args, masks);
+      }
+      if (args.length < count) return false;
+      const tests = schema.tests;
+      for (let i = 0; i < count; i++) {
+        if (!tests[i](args[i])) return false;
+      }
+      return true;
+    };
+    compiledSchemas.set(checker, schema);
+    return checker;
+  }
+
+  /**
+   * ### JSTypeChecker.checkAll
+   * Validate many rows against one schema (a type list or a checker from
+   * `compile`) without allocating per row.
+   * Returns a pass/fail byte and the first failing column per row.
+   * With `stopOnFirst`, checking stops after the first failing row.
+   * @example
+   * const { passed, failedColumn } = JSTC.checkAll(csvRows, JSTC.compile(["string", "number"]));
+   */
+  checkAll(
+    rows: readonly unknown[][],
+    schema: JSTypeOrArray[] | CompiledChecker,
+    options: CheckAllOptions = {},
+  ): CheckAllResult {
+    if (!Array.isArray(rows)) {
+      warnJSTC(
+        "JSTC.checkAll",
+        "Invalid first argument.",
+        "The first argument must be an array of rows.",
+        "Using [] as fallback.",
+      );
+      rows = [];
+    }
+    const stopOnFirst = Boolean(options?.stopOnFirst);
+    const result: CheckAllResult = {
+      passed: new Uint8Array(rows.length),
+      failedColumn: new Int32Array(rows.length).fill(-1),
+      failures: 0,
+      checked: 0,
+    };
+
+    const compiled =
+      typeof schema === "function"
+        ? compiledSchemas.get(schema)
+        : this.#createSchema(schema, "JSTC.checkAll");
+    if (!compiled) {
+      // A plain predicate: only pass/fail is known.
+      const predicate = schema as CompiledChecker;
+      for (let r = 0; r < rows.length; r++) {
+        result.checked++;
+        const row = rows[r];
+        if (Array.isArray(row) && predicate(...row)) {
+          result.passed[r] = 1;
+        } else {
+          result.failures++;
+          if (stopOnFirst) break;
+        }
+      }
+      return result;
+    }
+
+    if (compiled.version !== this.#handlerVersion) this.#resolveSchema(compiled);
+    const { count, tests, masks } = compiled;
+    if (masks !== null && native && count >= NATIVE_PRIMITIVE_MIN_ARGS) {
+      result.checked = native.checkRows(rows, masks, result.passed, result.failedColumn, stopOnFirst);
+      for (let r = 0; r < result.checked; r++) result.failures += 1 - result.passed[r];
+      return result;
+    }
+
+    for (let r = 0; r < rows.length; r++) {
+      result.checked++;
+      const row = rows[r];
+      let failed = -1;
+      if (!Array.isArray(row)) {
+        failed = 0;
+      } else {
+        const length = row.length < count ? row.length : count;
+        for (let i = 0; i < length; i++) {
+          if (!tests[i](row[i])) {
+            failed = i;
+            break;
+          }
+        }
+        if (failed === -1 && row.length < count) failed = row.length;
+      }
+      if (failed === -1) {
+        result.passed[r] = 1;
+      } else {
+        result.failedColumn[r] = failed;
+        result.failures++;
+        if (stopOnFirst) break;
+      }
+    }
+    return result;
+  }
+
+  #createSchema(types: JSTypeOrArray[], scope: string): CompiledSchema {
+    if (!Array.isArray(types)) {
+      warnJSTC(
+        scope,
+        "Invalid types argument.",
+        "The types must be an array of types.",
+        "Using [givenValue] as fallback.",
+      );
+      types = [types];
+    }
+    const schema: CompiledSchema = {
+      unions: types.map((e) => (Array.isArray(e) ? e.slice() : [e])),
+      count: types.length,
+      tests: [],
+      masks: null,
+      version: -1,
+    };
+    this.#resolveSchema(schema);
+    return schema;
+  }
+
+  #resolveSchema(schema: CompiledSchema): void {
+    schema.tests = schema.unions.map((u) => this.#compileUnion(u));
+    schema.masks = this.#primitiveMasks(schema.unions);
+    schema.version = this.#handlerVersion;
+  }
+
+  #compileType(t: JSType): ValueTest {
+    if (typeof t === "function") return (value) => value instanceof t;
+    if (typeof t !== "string") return NEVER;
+    const handler = this.#__CustomHandler[t];
+    if (handler) return handler;
+    return Object.prototype.hasOwnProperty.call(TYPEOF_TESTS, t)
+      ? TYPEOF_TESTS[t as PrimitiveType]
+      : NEVER;
+  }
+
+  /**
+   * One typeof bitmask per argument, or null when any alternative is a
+   * constructor or a custom handler.
+   */
+  #primitiveMasks(unions: JSType[][]): Uint8Array | null {
+    const masks = new Uint8Array(unions.length);
+    for (let i = 0; i < unions.length; i++) {
+      for (const tRaw of unions[i]) {
+        if (typeof tRaw !== "string") return null;
+        for (const t of tRaw.split("|")) {
+          if (this.#__CustomHandler[t]) return null;
+          if (Object.prototype.hasOwnProperty.call(TYPEOF_BITS, t)) {
+            masks[i] |= TYPEOF_BITS[t as PrimitiveType];
+          }
+        }
+      }
+    }
+    return masks;
+  }
+
+  #compileUnion(alternatives: JSType[]): ValueTest {
+    const tests: ValueTest[] = [];
+    for (const tRaw of alternatives) {
+      const unionTypes = typeof tRaw === "string" ? tRaw.split("|") : [tRaw];
+      for (const t of unionTypes) tests.push(this.#compileType(t));
+    }
+    if (tests.length === 1) return tests[0];
+    if (tests.length === 2) {
+      const [a, b] = tests;
+      return (value) => a(value) || b(value);
+    }
+    return (value) => {
+      for (let i = 0; i < tests.length; i++) {
+        if (tests[i](value)) return true;
+      }
+      return false;
+    };
+  }
+
   /**
    * ### JSTypeChecker.addCustomHandler
    * Create a custom handler for checking types.
@@ -205,6 +477,7 @@ export class JSTypeChecker {
       handler = () => false;
     }
     this.#__CustomHandler[name] = handler;
+    this.#handlerVersion++;
   }
 }
 
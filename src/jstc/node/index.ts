@@ -0,0 +1,27 @@
+/**
+ * # @briklab/lib/jstc/node
+ * Typed access to the optional native jstc addon.
+ * `native` is `null` when the addon is not built or cannot be loaded.
+ */
+
+export interface JSTCNativeAddon {
+  abiVersion: number;
+  /**
+   * Check `args` against one `typeof` bitmask per position (see `TYPEOF_BITS`).
+   * False when `args` is shorter than `masks`.
+   */
+  checkPrimitives(args: readonly unknown[], masks: Uint8Array): boolean;
+  /**
+   * Row-wise `checkPrimitives` for `JSTC.checkAll`. Fills `passed` and
+   * `failedColumn` and returns the number of rows checked.
+   */
+  checkRows(
+    rows: readonly unknown[],
+    masks: Uint8Array,
+    passed: Uint8Array,
+    failedColumn: Int32Array,
+    stopOnFirst: boolean,
+  ): number;
+}
+
+export { native } from "../index.js";
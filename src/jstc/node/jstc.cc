@@ -0,0 +1,175 @@
+// Node-API kernels of the jstc module.
+//
+// Linked into the briklab_core addon (src/native/binding.gyp), which exposes
+// them as `core.jstc`.
+
+#include <node_api.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "core.hpp"
+#include "napi_util.hpp"
+
+namespace {
+
+using briklab::napi::TypedView;
+using briklab::napi::typedView;
+
+// typeof bits, keep in sync with TYPEOF_BITS in src/jstc/index.ts.
+enum : uint8_t {
+  kString = 1 << 0,
+  kNumber = 1 << 1,
+  kBoolean = 1 << 2,
+  kObject = 1 << 3,
+  kFunction = 1 << 4,
+  kUndefined = 1 << 5,
+  kSymbol = 1 << 6,
+  kBigint = 1 << 7,
+};
+
+uint8_t typeofBit(napi_valuetype type) {
+  switch (type) {
+    case napi_undefined:
+      return kUndefined;
+    case napi_boolean:
+      return kBoolean;
+    case napi_number:
+      return kNumber;
+    case napi_string:
+      return kString;
+    case napi_symbol:
+      return kSymbol;
+    case napi_function:
+      return kFunction;
+    case napi_bigint:
+      return kBigint;
+    default:  // null, object, external
+      return kObject;
+  }
+}
+
+// checkPrimitives(args: unknown[], masks: Uint8Array): boolean
+// masks[i] is the set of typeof results accepted for args[i].
+napi_value CheckPrimitives(napi_env env, napi_callback_info info) {
+  size_t argc = 2;
+  napi_value argv[2];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  TypedView masks;
+  bool isArray = false;
+  if (argc < 2 || napi_is_array(env, argv[0], &isArray) != napi_ok || !isArray ||
+      !typedView(env, argv[1], masks) || masks.type != napi_uint8_array) {
+    napi_throw_type_error(env, nullptr, "@briklab/lib/jstc: checkPrimitives(args, masks)");
+    return nullptr;
+  }
+
+  uint32_t length = 0;
+  BRIKLAB_CALL(env, napi_get_array_length(env, argv[0], &length));
+  const auto* mask = static_cast<const uint8_t*>(masks.data);
+
+  bool ok = length >= masks.length;
+  for (uint32_t i = 0; ok && i < masks.length; i++) {
+    napi_value value;
+    napi_valuetype type;
+    BRIKLAB_CALL(env, napi_get_element(env, argv[0], i, &value));
+    BRIKLAB_CALL(env, napi_typeof(env, value, &type));
+    ok = (typeofBit(type) & mask[i]) != 0;
+  }
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_get_boolean(env, ok, &result));
+  return result;
+}
+
+// First column of `row` whose typeof is not in masks, or -1. A row shorter
+// than the schema fails at its length, a non-array row at column 0.
+bool firstFailure(napi_env env, napi_value row, const uint8_t* mask, size_t count, int32_t& failed) {
+  bool isArray = false;
+  if (napi_is_array(env, row, &isArray) != napi_ok) return false;
+  if (!isArray) {
+    failed = 0;
+    return true;
+  }
+  uint32_t length = 0;
+  if (napi_get_array_length(env, row, &length) != napi_ok) return false;
+  const uint32_t n = length < count ? length : static_cast<uint32_t>(count);
+  for (uint32_t i = 0; i < n; i++) {
+    napi_value value;
+    napi_valuetype type;
+    if (napi_get_element(env, row, i, &value) != napi_ok || napi_typeof(env, value, &type) != napi_ok)
+      return false;
+    if ((typeofBit(type) & mask[i]) == 0) {
+      failed = static_cast<int32_t>(i);
+      return true;
+    }
+  }
+  failed = length < count ? static_cast<int32_t>(length) : -1;
+  return true;
+}
+
+// checkRows(rows: unknown[], masks: Uint8Array, passed: Uint8Array,
+//           failedColumn: Int32Array, stopOnFirst: boolean): number
+// Returns the number of rows checked.
+napi_value CheckRows(napi_env env, napi_callback_info info) {
+  size_t argc = 5;
+  napi_value argv[5];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  TypedView masks, passed, failedColumn;
+  bool isArray = false;
+  bool stopOnFirst = false;
+  if (argc < 5 || napi_is_array(env, argv[0], &isArray) != napi_ok || !isArray ||
+      !typedView(env, argv[1], masks) || masks.type != napi_uint8_array ||
+      !typedView(env, argv[2], passed) || passed.type != napi_uint8_array ||
+      !typedView(env, argv[3], failedColumn) || failedColumn.type != napi_int32_array ||
+      napi_get_value_bool(env, argv[4], &stopOnFirst) != napi_ok) {
+    napi_throw_type_error(env, nullptr,
+                          "@briklab/lib/jstc: checkRows(rows, masks, passed, failedColumn, stopOnFirst)");
+    return nullptr;
+  }
+
+  uint32_t length = 0;
+  BRIKLAB_CALL(env, napi_get_array_length(env, argv[0], &length));
+  const auto rows = static_cast<uint32_t>(std::min<size_t>({length, passed.length, failedColumn.length}));
+  const auto* mask = static_cast<const uint8_t*>(masks.data);
+  auto* pass = static_cast<uint8_t*>(passed.data);
+  auto* column = static_cast<int32_t*>(failedColumn.data);
+
+  uint32_t checked = 0;
+  while (checked < rows) {
+    napi_value row;
+    int32_t failed = -1;
+    BRIKLAB_CALL(env, napi_get_element(env, argv[0], checked, &row));
+    if (!firstFailure(env, row, mask, masks.length, failed)) {
+      napi_throw_error(env, nullptr, "@briklab/lib native: checkRows");
+      return nullptr;
+    }
+    pass[checked] = failed < 0 ? 1 : 0;
+    column[checked] = failed;
+    checked++;
+    if (failed >= 0 && stopOnFirst) break;
+  }
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_create_uint32(env, checked, &result));
+  return result;
+}
+
+}  // namespace
+
+namespace briklab::jstc {
+
+napi_value Init(napi_env env, napi_value exports) {
+  BRIKLAB_CALL(env, briklab::napi::exportAbiVersion(env, exports));
+
+  napi_property_descriptor props[] = {
+      {"checkPrimitives", nullptr, CheckPrimitives, nullptr, nullptr, nullptr, napi_enumerable,
+       nullptr},
+      {"checkRows", nullptr, CheckRows, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+  };
+  BRIKLAB_CALL(env, napi_define_properties(env, exports, sizeof(props) / sizeof(*props), props));
+  return exports;
+}
+
+}  // namespace briklab::jstc
@@ -0,0 +1,124 @@
+// Bump allocator shared by the briklab_core kernels.
+//
+// A kernel opens a ScratchScope on entry and carves its temporary strings
+// and arrays out of scratch(); the scope gives everything back at once when
+// it ends. Blocks are kept for the next call, so steady-state calls do not
+// touch the heap. There is one scratch arena per thread because worker
+// threads run the same kernels in their own env.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace briklab {
+
+class Arena {
+ public:
+  // Position to rewind to; see mark() and rewind().
+  struct Mark {
+    std::size_t block;
+    std::size_t used;
+  };
+
+  explicit Arena(std::size_t blockSize = 64 * 1024) : blockSize_(blockSize) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  void* allocate(std::size_t size, std::size_t align = alignof(std::max_align_t)) {
+    if (block_ < blocks_.size()) {
+      Block& b = blocks_[block_];
+      const std::size_t offset = alignUp(b.data.get(), used_, align);
+      if (offset + size <= b.size) {
+        used_ = offset + size;
+        return b.data.get() + offset;
+      }
+    }
+    nextBlock(size + align);
+    Block& b = blocks_[block_];
+    const std::size_t offset = alignUp(b.data.get(), 0, align);
+    used_ = offset + size;
+    return b.data.get() + offset;
+  }
+
+  template <typename T>
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+  }
+
+  // Copy of `text` that lives until the arena is rewound past it.
+  std::string_view copy(std::string_view text) {
+    if (text.empty()) return {};
+    char* out = allocate<char>(text.size());
+    std::memcpy(out, text.data(), text.size());
+    return {out, text.size()};
+  }
+
+  Mark mark() const { return {block_, used_}; }
+
+  // Release everything allocated after `m`; the memory is reused.
+  void rewind(Mark m) {
+    block_ = m.block;
+    used_ = m.used;
+  }
+
+  void reset() { rewind({0, 0}); }
+
+ private:
+  struct Block {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  static std::size_t alignUp(const char* base, std::size_t offset, std::size_t align) {
+    const auto address = reinterpret_cast<std::uintptr_t>(base) + offset;
+    return offset + ((align - address % align) % align);
+  }
+
+  // Move to the next block that can hold `size` bytes, reusing kept blocks.
+  void nextBlock(std::size_t size) {
+    std::size_t next = block_ < blocks_.size() ? block_ + 1 : 0;
+    while (next < blocks_.size() && blocks_[next].size < size) next++;
+    if (next >= blocks_.size()) {
+      const std::size_t blockSize = size > blockSize_ ? size : blockSize_;
+      blocks_.push_back({std::make_unique<char[]>(blockSize), blockSize});
+      next = blocks_.size() - 1;
+    }
+    block_ = next;
+    used_ = 0;
+  }
+
+  std::size_t blockSize_;
+  std::vector<Block> blocks_;
+  std::size_t block_ = 0;
+  std::size_t used_ = 0;
+};
+
+// Per-thread arena for memory that only lives for one kernel call.
+inline Arena& scratch() {
+  thread_local Arena arena;
+  return arena;
+}
+
+// Rewinds scratch() to where it was when the scope was opened.
+class ScratchScope {
+ public:
+  ScratchScope() : arena_(scratch()), mark_(arena_.mark()) {}
+  ~ScratchScope() { arena_.rewind(mark_); }
+
+  ScratchScope(const ScratchScope&) = delete;
+  ScratchScope& operator=(const ScratchScope&) = delete;
+
+  Arena& arena() { return arena_; }
+
+ private:
+  Arena& arena_;
+  Arena::Mark mark_;
+};
+
+}  // namespace briklab
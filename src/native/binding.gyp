@@ -0,0 +1,23 @@
+{
+  "targets": [
+    {
+      "target_name": "briklab_core",
+      "sources": [
+        "core.cc",
+        "../color/node/color.cc",
+        "../jstc/node/jstc.cc",
+        "../stylesheet/node/stylesheet.cc"
+      ],
+      "include_dirs": ["."],
+      "defines": ["NAPI_VERSION=8"],
+      "cflags_cc": ["-std=c++20", "-O3"],
+      "xcode_settings": {
+        "CLANG_CXX_LANGUAGE_STANDARD": "c++20",
+        "OTHER_CPLUSPLUSFLAGS": ["-O3"]
+      },
+      "msvs_settings": {
+        "VCCLCompilerTool": { "AdditionalOptions": ["/std:c++20", "/O2"] }
+      }
+    }
+  ]
+}
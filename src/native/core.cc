@@ -0,0 +1,77 @@
+// Node-API entry point of the briklab_core addon.
+//
+// Every module's kernels are linked into this one binary and exported as
+// sub-objects (`core.color`, `core.jstc`, ...), so a process opens a single
+// .node file. Loaded by src/native/load.ts as dist/native/briklab_core.node.
+
+#include <node_api.h>
+
+#include <utility>
+
+#include "core.hpp"
+#include "cpu.hpp"
+#include "napi_util.hpp"
+
+namespace briklab {
+
+EnvData* envData(napi_env env) {
+  void* data = nullptr;
+  if (napi_get_instance_data(env, &data) != napi_ok) return nullptr;
+  return static_cast<EnvData*>(data);
+}
+
+}  // namespace briklab
+
+namespace {
+
+void FinalizeEnvData(napi_env env, void* data, void* /*hint*/) {
+  auto* envData = static_cast<briklab::EnvData*>(data);
+  envData->strings.release(env);
+  delete envData;
+}
+
+napi_status addModule(napi_env env, napi_value exports, const char* name,
+                      napi_value (*init)(napi_env, napi_value)) {
+  napi_value module;
+  napi_status status = napi_create_object(env, &module);
+  if (status != napi_ok) return status;
+  if (init(env, module) == nullptr) return napi_pending_exception;
+  return napi_set_named_property(env, exports, name, module);
+}
+
+// exports.isa (kernel flavor in use) and exports.cpuFeatures.
+napi_status exportCpu(napi_env env, napi_value exports) {
+  using briklab::cpu::Isa;
+  const briklab::cpu::Features& f = briklab::cpu::features();
+  napi_value isa, list;
+  napi_status status = napi_create_string_utf8(env, briklab::cpu::isaName(briklab::cpu::isa()),
+                                               NAPI_AUTO_LENGTH, &isa);
+  if (status == napi_ok) status = napi_set_named_property(env, exports, "isa", isa);
+  if (status == napi_ok) status = napi_create_array(env, &list);
+  uint32_t length = 0;
+  const std::pair<bool, Isa> flags[] = {{f.sse42, Isa::Sse42}, {f.avx2, Isa::Avx2}, {f.neon, Isa::Neon}};
+  for (const auto& [present, which] : flags) {
+    if (status != napi_ok || !present) continue;
+    napi_value name;
+    status = napi_create_string_utf8(env, briklab::cpu::isaName(which), NAPI_AUTO_LENGTH, &name);
+    if (status == napi_ok) status = napi_set_element(env, list, length++, name);
+  }
+  if (status == napi_ok) status = napi_set_named_property(env, exports, "cpuFeatures", list);
+  return status;
+}
+
+napi_value Init(napi_env env, napi_value exports) {
+  BRIKLAB_CALL(env, napi_set_instance_data(env, new briklab::EnvData(), FinalizeEnvData, nullptr));
+  BRIKLAB_CALL(env, briklab::napi::exportAbiVersion(env, exports));
+  BRIKLAB_CALL(env, exportCpu(env, exports));
+
+  // Keys are the module directory names under src/.
+  BRIKLAB_CALL(env, addModule(env, exports, "color", briklab::color::Init));
+  BRIKLAB_CALL(env, addModule(env, exports, "jstc", briklab::jstc::Init));
+  BRIKLAB_CALL(env, addModule(env, exports, "stylesheet", briklab::stylesheet::Init));
+  return exports;
+}
+
+}  // namespace
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
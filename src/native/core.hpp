@@ -0,0 +1,26 @@
+// Entry points of the modules linked into the briklab_core addon, and the
+// state core.cc keeps per env.
+
+#pragma once
+
+#include <node_api.h>
+
+#include "intern.hpp"
+
+namespace briklab {
+
+// Each fills `exports` with its kernels; core.cc exposes it as
+// `core[<module>]`.
+namespace color { napi_value Init(napi_env env, napi_value exports); }
+namespace jstc { napi_value Init(napi_env env, napi_value exports); }
+namespace stylesheet { napi_value Init(napi_env env, napi_value exports); }
+
+// One per env (main thread or worker), owned by core.cc.
+struct EnvData {
+  napi::StringCache strings;
+};
+
+// EnvData of `env`; null only if the addon failed to initialize.
+EnvData* envData(napi_env env);
+
+}  // namespace briklab
@@ -0,0 +1,116 @@
+// CPU feature detection for the briklab_core kernels.
+//
+// isa() is decided once, the first time a kernel asks (in practice while the
+// addon initializes), from CPUID on x86 and the architecture baseline on
+// arm64. BRIKLAB_NATIVE_ISA=scalar|sse4.2|avx2|neon lowers the choice, e.g.
+// to compare kernels or to rule one out; it never enables an ISA the CPU
+// lacks.
+
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BRIKLAB_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define BRIKLAB_ARM64 1
+#endif
+
+// Per-function target attributes (GCC and Clang); MSVC builds keep the
+// scalar x86 kernels.
+#if defined(BRIKLAB_X86) && (defined(__GNUC__) || defined(__clang__))
+#define BRIKLAB_X86_TARGETS 1
+#define BRIKLAB_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace briklab::cpu {
+
+enum class Isa { Scalar = 0, Sse42 = 1, Avx2 = 2, Neon = 3 };
+
+inline const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::Sse42:
+      return "sse4.2";
+    case Isa::Avx2:
+      return "avx2";
+    case Isa::Neon:
+      return "neon";
+    default:
+      return "scalar";
+  }
+}
+
+struct Features {
+  bool sse42 = false;
+  bool avx2 = false;
+  bool neon = false;
+};
+
+inline Features detectFeatures() {
+  Features f;
+#if defined(BRIKLAB_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+  int regs[4];
+  __cpuid(regs, 0);
+  const int maxLeaf = regs[0];
+  __cpuid(regs, 1);
+  f.sse42 = (regs[2] & (1 << 20)) != 0;
+  const bool osxsave = (regs[2] & (1 << 27)) != 0;
+  const bool avx = (regs[2] & (1 << 28)) != 0;
+  // AVX state must be enabled by the OS (XCR0 bits 1 and 2).
+  const bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+  if (maxLeaf >= 7) {
+    __cpuidex(regs, 7, 0);
+    f.avx2 = ymm && (regs[1] & (1 << 5)) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  f.sse42 = __builtin_cpu_supports("sse4.2");
+  f.avx2 = __builtin_cpu_supports("avx2");
+#endif
+#elif defined(BRIKLAB_ARM64)
+  // Advanced SIMD is part of the AArch64 baseline.
+  f.neon = true;
+#endif
+  return f;
+}
+
+inline const Features& features() {
+  static const Features f = detectFeatures();
+  return f;
+}
+
+// Best ISA the kernels were actually built for; without target attributes
+// (MSVC) x86 runs the scalar kernels whatever the CPU supports.
+inline Isa best(const Features& f) {
+#if defined(BRIKLAB_X86_TARGETS)
+  if (f.avx2) return Isa::Avx2;
+  if (f.sse42) return Isa::Sse42;
+#endif
+  if (f.neon) return Isa::Neon;
+  return Isa::Scalar;
+}
+
+inline Isa detectIsa() {
+  const Features& f = features();
+  Isa isa = best(f);
+  const char* cap = std::getenv("BRIKLAB_NATIVE_ISA");
+  if (cap == nullptr) return isa;
+  if (std::strcmp(cap, "scalar") == 0) return Isa::Scalar;
+  if (std::strcmp(cap, "sse4.2") == 0 && isa == Isa::Avx2) return Isa::Sse42;
+  return isa;
+}
+
+// Kernel flavor every dispatching kernel uses.
+inline Isa isa() {
+  static const Isa chosen = detectIsa();
+  return chosen;
+}
+
+}  // namespace briklab::cpu
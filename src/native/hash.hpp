@@ -0,0 +1,77 @@
+// Content hashing shared by the briklab_core kernels.
+//
+// hash64() is two XXH32 lanes (seeds 0 and 1) over the same bytes, run in
+// one pass. XXH32 only needs 32-bit multiplies, so src/stylesheet/hash.ts
+// computes the identical value in JS with Math.imul and cache keys do not
+// depend on whether the addon is loaded.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace briklab::hash {
+
+inline constexpr std::uint32_t kPrime1 = 0x9e3779b1u;
+inline constexpr std::uint32_t kPrime2 = 0x85ebca77u;
+inline constexpr std::uint32_t kPrime3 = 0xc2b2ae3du;
+inline constexpr std::uint32_t kPrime4 = 0x27d4eb2fu;
+inline constexpr std::uint32_t kPrime5 = 0x165667b1u;
+
+inline std::uint32_t rotl(std::uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+inline std::uint32_t read32(const unsigned char* p) {
+  return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+         static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+inline std::uint32_t step(std::uint32_t acc, std::uint32_t input) {
+  return rotl(acc + input * kPrime2, 13) * kPrime1;
+}
+
+// XXH32 state; lanes hashing the same bytes share the reads.
+struct Xxh32 {
+  explicit Xxh32(std::uint32_t seed)
+      : seed(seed), v{seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1} {}
+
+  void stripe(const unsigned char* p) {
+    for (int i = 0; i < 4; i++) v[i] = step(v[i], read32(p + i * 4));
+  }
+
+  std::uint32_t finish(const unsigned char* tail, std::size_t rest, std::size_t length) const {
+    std::uint32_t h = length >= 16 ? rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18)
+                                   : seed + kPrime5;
+    h += static_cast<std::uint32_t>(length);
+    for (; rest >= 4; rest -= 4, tail += 4) h = rotl(h + read32(tail) * kPrime3, 17) * kPrime4;
+    for (; rest > 0; rest--, tail++) h = rotl(h + *tail * kPrime5, 11) * kPrime1;
+    h ^= h >> 15;
+    h *= kPrime2;
+    h ^= h >> 13;
+    h *= kPrime3;
+    h ^= h >> 16;
+    return h;
+  }
+
+  std::uint32_t seed;
+  std::uint32_t v[4];
+};
+
+inline std::uint64_t hash64(const void* data, std::size_t length) {
+  const auto* p = static_cast<const unsigned char*>(data);
+  Xxh32 hi(0), lo(1);
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    hi.stripe(p + i);
+    lo.stripe(p + i);
+  }
+  return static_cast<std::uint64_t>(hi.finish(p + i, length - i, length)) << 32 |
+         lo.finish(p + i, length - i, length);
+}
+
+// 16 lowercase hex digits, most significant first; `out` needs 16 bytes.
+inline void toHex(std::uint64_t value, char* out) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  for (int i = 15; i >= 0; i--, value >>= 4) out[i] = kDigits[value & 0xf];
+}
+
+}  // namespace briklab::hash
@@ -0,0 +1,102 @@
+// String interning shared by the briklab_core kernels.
+//
+// Interner hands out one dense id per distinct string and keeps a single
+// copy of its bytes. StringCache builds on it to create each JS string for
+// a recurring name (CSS property keys, option names) once per env instead
+// of on every call.
+
+#pragma once
+
+#include <node_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.hpp"
+
+namespace briklab {
+
+class Interner {
+ public:
+  static constexpr std::uint32_t kNone = 0xffffffff;
+
+  // Id of `text`, adding it if it is new.
+  std::uint32_t intern(std::string_view text) {
+    if (const auto it = ids_.find(text); it != ids_.end()) return it->second;
+    const auto id = static_cast<std::uint32_t>(views_.size());
+    const std::string_view stored = storage_.copy(text);
+    views_.push_back(stored);
+    ids_.emplace(stored, id);
+    return id;
+  }
+
+  // Id of `text`, or kNone when it was never interned.
+  std::uint32_t find(std::string_view text) const {
+    const auto it = ids_.find(text);
+    return it == ids_.end() ? kNone : it->second;
+  }
+
+  std::string_view view(std::uint32_t id) const { return views_[id]; }
+  std::size_t size() const { return views_.size(); }
+
+ private:
+  Arena storage_{16 * 1024};
+  std::unordered_map<std::string_view, std::uint32_t> ids_;
+  std::vector<std::string_view> views_;
+};
+
+namespace napi {
+
+// JS strings for interned names, held in one JS array per env. NAPI_VERSION 8
+// only allows references to objects, so the strings live in an array that
+// is referenced instead.
+class StringCache {
+ public:
+  // Longer strings and strings past the cap are created fresh every time.
+  static constexpr std::size_t kMaxLength = 64;
+  static constexpr std::size_t kMaxEntries = 4096;
+
+  napi_status get(napi_env env, std::string_view text, napi_value* out) {
+    if (text.size() > kMaxLength) return create(env, text, out);
+
+    napi_value strings;
+    napi_status status = array(env, &strings);
+    if (status != napi_ok) return status;
+
+    std::uint32_t id = names_.find(text);
+    if (id != Interner::kNone) return napi_get_element(env, strings, id, out);
+    if (names_.size() >= kMaxEntries) return create(env, text, out);
+
+    status = create(env, text, out);
+    const auto next = static_cast<std::uint32_t>(names_.size());
+    if (status == napi_ok) status = napi_set_element(env, strings, next, *out);
+    if (status == napi_ok) names_.intern(text);
+    return status;
+  }
+
+  void release(napi_env env) {
+    if (array_ != nullptr) napi_delete_reference(env, array_);
+    array_ = nullptr;
+  }
+
+ private:
+  static napi_status create(napi_env env, std::string_view text, napi_value* out) {
+    return napi_create_string_utf8(env, text.data(), text.size(), out);
+  }
+
+  napi_status array(napi_env env, napi_value* out) {
+    if (array_ != nullptr) return napi_get_reference_value(env, array_, out);
+    napi_status status = napi_create_array(env, out);
+    if (status != napi_ok) return status;
+    return napi_create_reference(env, *out, 1, &array_);
+  }
+
+  Interner names_;
+  napi_ref array_ = nullptr;
+};
+
+}  // namespace napi
+}  // namespace briklab
@@ -1,7 +1,114 @@
+/**
+ * Loader for the optional native addon.
+ *
+ * All kernels live in one binary, `briklab_core.node`, built from
+ * `src/native/binding.gyp`. A local `pnpm build:native` puts it next to this
+ * file (in `dist/native/`); published packages also ship prebuilds as
+ * `dist/native/prebuilds/<platform>-<arch>/briklab_core.napi-v<N>.node`.
+ * Every module calls `loadNativeAddon("<module>")` and gets its sub-object of
+ * the addon or `null`, in which case the pure TS implementation is used. The
+ * binary is opened once per thread.
+ */
+
 type NativeAddon = Record<string, unknown>;
 
-export function loadNativeAddon(moduleUrl: string, addonName: string): NativeAddon | null {
-  void moduleUrl;
-  void addonName;
+/**
+ * ABI version the core addon must export as `abiVersion`.
+ * Bump it whenever the shape of the exported kernels changes.
+ */
+export const NATIVE_ABI_VERSION = 2;
+
+const CORE_NAME = "briklab_core";
+
+/** NAPI_VERSION the addon is compiled against (see binding.gyp). */
+const MIN_NAPI_VERSION = 8;
+
+let core: NativeAddon | null | undefined;
+let coreFile: string | undefined;
+let failure: string | undefined;
+
+function nativeDisabled(): boolean {
+  const flag = globalThis.process?.env?.BRIKLAB_NATIVE;
+  return flag === "0" || flag === "false" || flag === "off";
+}
+
+function tryLoad(): NativeAddon | null {
+  // Browsers and runtimes without `process.getBuiltinModule` stay on the TS path.
+  const getBuiltin = globalThis.process?.getBuiltinModule;
+  if (typeof getBuiltin !== "function") return null;
+  if (!import.meta.url.startsWith("file:")) return null;
+
+  const { createRequire } = getBuiltin("node:module") as typeof import("node:module");
+  const { existsSync } = getBuiltin("node:fs") as typeof import("node:fs");
+  const { fileURLToPath } = getBuiltin("node:url") as typeof import("node:url");
+
+  const req = createRequire(import.meta.url);
+  for (const candidate of candidates()) {
+    const file = fileURLToPath(new URL(candidate, import.meta.url));
+    if (!existsSync(file)) continue;
+
+    let addon: NativeAddon;
+    try {
+      addon = req(file) as NativeAddon;
+    } catch (e) {
+      // e.g. a prebuild for another libc; try the next candidate.
+      failure = `Failed to load ${file}: ${(e as Error)?.message ?? e}`;
+      continue;
+    }
+    if (!addon || addon.abiVersion !== NATIVE_ABI_VERSION) {
+      failure = `ABI mismatch for ${file}: expected ${NATIVE_ABI_VERSION}, got ${addon?.abiVersion}.`;
+      continue;
+    }
+    coreFile = file;
+    failure = undefined;
+    return addon;
+  }
   return null;
 }
+
+/**
+ * Addon paths relative to this file, best first: a local build, then the
+ * prebuild for this platform with the newest N-API version the runtime has.
+ */
+function candidates(): string[] {
+  const { platform, arch, versions } = globalThis.process;
+  const files = [`./${CORE_NAME}.node`];
+  const napi = Number(versions?.napi) || MIN_NAPI_VERSION;
+  for (let v = napi; v >= MIN_NAPI_VERSION; v--) {
+    files.push(`./prebuilds/${platform}-${arch}/${CORE_NAME}.napi-v${v}.node`);
+  }
+  return files;
+}
+
+function loadCore(): NativeAddon | null {
+  if (core === undefined) core = nativeDisabled() ? null : tryLoad();
+  return core;
+}
+
+/**
+ * Kernels of `moduleName` (a directory under src/) from the core addon.
+ * Returns `null` when the addon is missing, fails to load, fails the ABI
+ * handshake, has no kernels for that module or when `BRIKLAB_NATIVE=0` is
+ * set. The addon is loaded on the first call.
+ */
+export function loadNativeAddon(moduleName: string): NativeAddon | null {
+  const addon = loadCore()?.[moduleName];
+  return addon && typeof addon === "object" ? (addon as NativeAddon) : null;
+}
+
+/**
+ * Which binary was loaded and which kernel flavor it picked for this CPU
+ * (`isa` is "avx2", "sse4.2", "neon" or "scalar"). `null` on the TS path.
+ */
+export function nativeInfo(): { file: string; isa: string; cpuFeatures: string[] } | null {
+  if (!loadCore() || coreFile === undefined) return null;
+  const { isa, cpuFeatures } = core as { isa?: string; cpuFeatures?: string[] };
+  return { file: coreFile, isa: String(isa), cpuFeatures: [...(cpuFeatures ?? [])] };
+}
+
+/**
+ * Why the core addon exists on disk but could not be used, if it could not.
+ */
+export function nativeLoadError(): string | undefined {
+  return failure;
+}
@@ -0,0 +1,74 @@
+// Small Node-API helpers shared by the kernels in src/<module>/node.
+//
+// src/native/binding.gyp puts this directory on the include path.
+
+#pragma once
+
+#include <node_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "arena.hpp"
+
+namespace briklab::napi {
+
+// Must match NATIVE_ABI_VERSION in src/native/load.ts.
+inline constexpr uint32_t kAbiVersion = 2;
+
+// Evaluate a napi_status call; throw and return nullptr from the binding on failure.
+#define BRIKLAB_CALL(env, call)                                             \
+  do {                                                                      \
+    if ((call) != napi_ok) {                                                \
+      napi_throw_error((env), nullptr, "@briklab/lib native: " #call);      \
+      return nullptr;                                                       \
+    }                                                                       \
+  } while (0)
+
+// Reads a JS string as UTF-8 into `out`, reusing its capacity. False for non-strings.
+inline bool readString(napi_env env, napi_value value, std::string& out) {
+  napi_valuetype type;
+  if (napi_typeof(env, value, &type) != napi_ok || type != napi_string) return false;
+  size_t length = 0;
+  if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) return false;
+  out.resize(length);
+  return napi_get_value_string_utf8(env, value, out.data(), length + 1, &length) == napi_ok;
+}
+
+// Reads a JS string as UTF-8 into memory from `arena`. False for non-strings.
+inline bool readString(napi_env env, napi_value value, Arena& arena, std::string_view& out) {
+  napi_valuetype type;
+  if (napi_typeof(env, value, &type) != napi_ok || type != napi_string) return false;
+  size_t length = 0;
+  if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok) return false;
+  char* data = arena.allocate<char>(length + 1);
+  if (napi_get_value_string_utf8(env, value, data, length + 1, &length) != napi_ok) return false;
+  out = std::string_view(data, length);
+  return true;
+}
+
+// Typed array argument; `data` is null when `value` is not a typed array.
+struct TypedView {
+  napi_typedarray_type type = napi_int8_array;
+  void* data = nullptr;
+  size_t length = 0;
+};
+
+inline bool typedView(napi_env env, napi_value value, TypedView& view) {
+  bool isTyped = false;
+  if (napi_is_typedarray(env, value, &isTyped) != napi_ok || !isTyped) return false;
+  return napi_get_typedarray_info(env, value, &view.type, &view.length, &view.data, nullptr,
+                                  nullptr) == napi_ok;
+}
+
+// Sets exports.abiVersion for the loader handshake.
+inline napi_status exportAbiVersion(napi_env env, napi_value exports) {
+  napi_value abi;
+  napi_status status = napi_create_uint32(env, kAbiVersion, &abi);
+  if (status != napi_ok) return status;
+  return napi_set_named_property(env, exports, "abiVersion", abi);
+}
+
+}  // namespace briklab::napi
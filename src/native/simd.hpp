@@ -0,0 +1,78 @@
+// Byte-scanning kernels with per-ISA variants, picked through cpu::isa().
+//
+// Each variant gives the same answer as the scalar loop; the wide ones only
+// look at more bytes per step.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "cpu.hpp"
+
+#if defined(BRIKLAB_X86_TARGETS)
+#include <immintrin.h>
+#endif
+#if defined(BRIKLAB_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace briklab::simd {
+
+inline bool isAsciiScalar(const char* data, std::size_t size) {
+  unsigned char bits = 0;
+  for (std::size_t i = 0; i < size; i++) bits |= static_cast<unsigned char>(data[i]);
+  return bits < 0x80;
+}
+
+#if defined(BRIKLAB_X86_TARGETS)
+BRIKLAB_TARGET("sse4.2") inline bool isAsciiSse42(const char* data, std::size_t size) {
+  std::size_t i = 0;
+  __m128i bits = _mm_setzero_si128();
+  for (; i + 16 <= size; i += 16) {
+    bits = _mm_or_si128(bits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+  }
+  return _mm_movemask_epi8(bits) == 0 && isAsciiScalar(data + i, size - i);
+}
+
+BRIKLAB_TARGET("avx2") inline bool isAsciiAvx2(const char* data, std::size_t size) {
+  std::size_t i = 0;
+  __m256i bits = _mm256_setzero_si256();
+  for (; i + 32 <= size; i += 32) {
+    bits = _mm256_or_si256(bits, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+  }
+  return _mm256_movemask_epi8(bits) == 0 && isAsciiSse42(data + i, size - i);
+}
+#endif
+
+#if defined(BRIKLAB_ARM64)
+inline bool isAsciiNeon(const char* data, std::size_t size) {
+  std::size_t i = 0;
+  uint8x16_t bits = vdupq_n_u8(0);
+  for (; i + 16 <= size; i += 16) {
+    bits = vorrq_u8(bits, vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i)));
+  }
+  return vmaxvq_u8(bits) < 0x80 && isAsciiScalar(data + i, size - i);
+}
+#endif
+
+// True when every byte of `text` is below 0x80.
+inline bool isAscii(std::string_view text) {
+  switch (cpu::isa()) {
+#if defined(BRIKLAB_X86_TARGETS)
+    case cpu::Isa::Avx2:
+      return isAsciiAvx2(text.data(), text.size());
+    case cpu::Isa::Sse42:
+      return isAsciiSse42(text.data(), text.size());
+#endif
+#if defined(BRIKLAB_ARM64)
+    case cpu::Isa::Neon:
+      return isAsciiNeon(text.data(), text.size());
+#endif
+    default:
+      return isAsciiScalar(text.data(), text.size());
+  }
+}
+
+}  // namespace briklab::simd
@@ -0,0 +1,131 @@
+/**
+ * # StyleSheetCache
+ * On-disk cache of generated CSS, keyed by StyleSheet#hash().
+ *
+ * Each entry is a plain `<hash>.css` file, so unchanged sheets skip
+ * generate() (and with it cssom) across process restarts and CI runs.
+ * Hits are memory-mapped through the native addon when it is available.
+ * Entries are written to a temporary file and renamed into place, so a
+ * concurrent reader sees either the old entry or the complete new one.
+ * Outside Node the cache is a pass-through.
+ */
+
+import { createWarner } from "../warner/index.js";
+import { loadNativeAddon } from "../native/load.js";
+import type { StylesheetNativeAddon } from "./node/index.js";
+
+type NodeFs = typeof import("node:fs");
+type NodePath = typeof import("node:path");
+
+const cacheWarner = createWarner("@briklab/lib/stylesheet");
+const native = loadNativeAddon("stylesheet") as StylesheetNativeAddon | null;
+
+/** The part of StyleSheet that the cache uses. */
+export interface CacheableStyleSheet {
+  hash(): string;
+  generate(): string;
+}
+
+let node: { fs: NodeFs; path: NodePath } | null | undefined;
+
+function getNode(): { fs: NodeFs; path: NodePath } | null {
+  if (node === undefined) {
+    const getBuiltin = globalThis.process?.getBuiltinModule;
+    node =
+      typeof getBuiltin === "function"
+        ? { fs: getBuiltin("node:fs") as NodeFs, path: getBuiltin("node:path") as NodePath }
+        : null;
+  }
+  return node;
+}
+
+let encoder: TextEncoder | undefined;
+let decoder: TextDecoder | undefined;
+let tmpCounter = 0;
+
+function warnCache(scope: string, message: string, hint?: string, otherMessage?: string): void {
+  if (!cacheWarner.enabled) return;
+  cacheWarner.warn({ scope, message, hint, otherMessage });
+}
+
+export class StyleSheetCache {
+  #directory: string | null;
+
+  /**
+   * ## constructor
+   * @param directory Where the `<hash>.css` entries live; created on the first write.
+   */
+  constructor(directory: string) {
+    if (typeof directory !== "string" || directory.length === 0) {
+      warnCache(
+        "StyleSheetCache.constructor",
+        "Invalid cache directory.",
+        `Expected a non-empty path string. Received: ${JSON.stringify(directory)}.`,
+        "Caching is disabled for this instance.",
+      );
+      this.#directory = null;
+      return;
+    }
+    this.#directory = getNode() ? directory : null;
+  }
+
+  /** Path of the entry for `hash`, or `undefined` when caching is disabled. */
+  file(hash: string): string | undefined {
+    const n = getNode();
+    return this.#directory === null || !n ? undefined : n.path.join(this.#directory, `${hash}.css`);
+  }
+
+  /** sheet.generate(), read from the cache when an entry for sheet.hash() exists. */
+  generate(sheet: CacheableStyleSheet): string {
+    const file = this.#directory === null ? undefined : this.file(sheet.hash());
+    if (file === undefined) return sheet.generate();
+    const hit = this.#read(file);
+    if (hit) return (decoder ??= new TextDecoder()).decode(hit);
+    const css = sheet.generate();
+    this.#write(file, (encoder ??= new TextEncoder()).encode(css));
+    return css;
+  }
+
+  /**
+   * UTF-8 bytes of sheet.generate(). A hit returns the mapped file itself
+   * (or a copy of it without the native addon), without decoding.
+   */
+  generateBytes(sheet: CacheableStyleSheet): Uint8Array {
+    const file = this.#directory === null ? undefined : this.file(sheet.hash());
+    const hit = file === undefined ? undefined : this.#read(file);
+    if (hit) return hit;
+    const bytes = (encoder ??= new TextEncoder()).encode(sheet.generate());
+    if (file !== undefined) this.#write(file, bytes);
+    return bytes;
+  }
+
+  #read(file: string): Uint8Array | undefined {
+    const mapped = native?.mapFile(file);
+    if (mapped) return mapped;
+    try {
+      return getNode()!.fs.readFileSync(file);
+    } catch {
+      return undefined;
+    }
+  }
+
+  #write(file: string, bytes: Uint8Array): void {
+    const { fs } = getNode()!;
+    const tmp = `${file}.${globalThis.process.pid}.${tmpCounter++}.tmp`;
+    try {
+      fs.mkdirSync(this.#directory!, { recursive: true });
+      fs.writeFileSync(tmp, bytes);
+      fs.renameSync(tmp, file);
+    } catch (e) {
+      try {
+        fs.rmSync(tmp, { force: true });
+      } catch {}
+      warnCache(
+        "StyleSheetCache.generate",
+        `Could not write cache entry ${JSON.stringify(file)}: ${(e as Error)?.message ?? e}.`,
+        "Check that the cache directory is writable.",
+        "The generated CSS is returned uncached.",
+      );
+    }
+  }
+}
@@ -0,0 +1,76 @@
+/**
+ * 64-bit content hash used for stylesheet cache keys.
+ *
+ * Two XXH32 lanes (seeds 0 and 1) over the UTF-8 bytes of the input, run in
+ * one pass. It is the same function as `hash64()` in src/native/hash.hpp, so
+ * a key computed with the native addon matches one computed without it.
+ */
+
+import { loadNativeAddon } from "../native/load.js";
+import type { StylesheetNativeAddon } from "./node/index.js";
+
+const native = loadNativeAddon("stylesheet") as StylesheetNativeAddon | null;
+
+const PRIME1 = 0x9e3779b1 | 0;
+const PRIME2 = 0x85ebca77 | 0;
+const PRIME3 = 0xc2b2ae3d | 0;
+const PRIME4 = 0x27d4eb2f | 0;
+const PRIME5 = 0x165667b1 | 0;
+
+let encoder: TextEncoder | undefined;
+
+function rotl(x: number, r: number): number {
+  return (x << r) | (x >>> (32 - r));
+}
+
+function read32(bytes: Uint8Array, i: number): number {
+  return bytes[i] | (bytes[i + 1] << 8) | (bytes[i + 2] << 16) | (bytes[i + 3] << 24);
+}
+
+function step(acc: number, input: number): number {
+  return Math.imul(rotl((acc + Math.imul(input, PRIME2)) | 0, 13), PRIME1);
+}
+
+function finish(v: Int32Array, seed: number, bytes: Uint8Array, i: number): number {
+  const length = bytes.length;
+  let h =
+    length >= 16
+      ? (rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18)) | 0
+      : (seed + PRIME5) | 0;
+  h = (h + length) | 0;
+  for (; i + 4 <= length; i += 4) {
+    h = Math.imul(rotl((h + Math.imul(read32(bytes, i), PRIME3)) | 0, 17), PRIME4);
+  }
+  for (; i < length; i++) h = Math.imul(rotl((h + Math.imul(bytes[i], PRIME5)) | 0, 11), PRIME1);
+  h ^= h >>> 15;
+  h = Math.imul(h, PRIME2);
+  h ^= h >>> 13;
+  h = Math.imul(h, PRIME3);
+  h ^= h >>> 16;
+  return h >>> 0;
+}
+
+function hex32(x: number): string {
+  return x.toString(16).padStart(8, "0");
+}
+
+/** Pure TS twin of the native kernel. */
+export function hash64TS(text: string): string {
+  const bytes = (encoder ??= new TextEncoder()).encode(text);
+  const hi = new Int32Array([PRIME1 + PRIME2, PRIME2, 0, -PRIME1]);
+  const lo = new Int32Array([1 + PRIME1 + PRIME2, 1 + PRIME2, 1, 1 - PRIME1]);
+  let i = 0;
+  for (; i + 16 <= bytes.length; i += 16) {
+    for (let lane = 0; lane < 4; lane++) {
+      const input = read32(bytes, i + lane * 4);
+      hi[lane] = step(hi[lane], input);
+      lo[lane] = step(lo[lane], input);
+    }
+  }
+  return hex32(finish(hi, 0, bytes, i)) + hex32(finish(lo, 1, bytes, i));
+}
+
+/** 64-bit content hash of `text` as 16 hex digits. */
+export function hash64(text: string): string {
+  return native?.hash(text) ?? hash64TS(text);
+}
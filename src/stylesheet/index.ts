@@ -9,9 +9,22 @@ import Color from "../color/index.js";
 import { createWarner } from "../warner/index.js";
 import type { ProtectionLevel } from "../jstc/index.js";
 import { loadNativeAddon } from "../native/load.js";
+import type { StylesheetNativeAddon } from "./node/index.js";
+import { hash64 } from "./hash.js";
+import { RuleStore } from "./rules.js";
+import { TokenGraph, tokenName, type TokenDefinition, type TokenValue } from "./tokens.js";
+
+export { StyleSheetCache, type CacheableStyleSheet } from "./cache.js";
+export type { TokenDefinition, TokenReader, TokenValue } from "./tokens.js";
 
 const stylesheetWarner = createWarner("@briklab/lib/stylesheet");
-export const native = loadNativeAddon(import.meta.url, "stylesheet");
+export const native = loadNativeAddon("stylesheet") as StylesheetNativeAddon | null;
+
+const isObjectOrUndefined = JSTC.compile(["object|undefined"]);
+const isObject = JSTC.compile(["object"]);
+const isString = JSTC.compile(["string"]);
+const isStringOrStringArray = JSTC.compile(["string[]|string"]);
+const isNameAndObject = JSTC.compile(["string", "object"]);
 
 function formatStylesheetMessage(
   scope: string,
@@ -27,6 +40,85 @@ function formatStylesheetMessage(
     .filter((line): line is string => Boolean(line))
     .join("\n");
 }
+
+/** Structured stylesheet warning, skipped entirely when the warner is disabled. */
+function warnStylesheet(scope: string, message: string, hint?: string, otherMessage?: string): void {
+  if (!stylesheetWarner.enabled) return;
+  stylesheetWarner.warn({ scope, message, hint, otherMessage });
+}
+/** ECMAScript WhiteSpace and LineTerminator code units, as stripped by String#trim. */
+function isTrimmable(code: number): boolean {
+  return (
+    (code >= 9 && code <= 13) ||
+    code === 32 ||
+    code === 0xa0 ||
+    code === 0x1680 ||
+    (code >= 0x2000 && code <= 0x200a) ||
+    code === 0x2028 ||
+    code === 0x2029 ||
+    code === 0x202f ||
+    code === 0x205f ||
+    code === 0x3000 ||
+    code === 0xfeff
+  );
+}
+
+/** camelCase property names to their hyphenated CSS form; others unchanged. */
+function hyphenate(key: string): string {
+  return /[A-Z]/.test(key) ? key.replace(/([A-Z])/g, (match) => `-${match.toLowerCase()}`) : key;
+}
+
+/**
+ * Bumped by every change to any InlineStyle, so a StyleSheet can tell with
+ * one comparison that none of its styles changed. Sheets poll versions
+ * instead of subscribing to styles, so a shared style never keeps a sheet
+ * alive.
+ */
+let styleEdits = 0;
+
+/**
+ * Split inline CSS into parallel `keys`/`values` arrays in one pass.
+ * Rules are separated by ";", the key is everything before the first ":",
+ * camelCase keys are hyphenated and both sides are trimmed. Only the final
+ * key and value are sliced out of `css`; skipped rules are reported to `onSkip`.
+ */
+function tokenizeInlineCSS(
+  css: string,
+  keys: string[],
+  values: string[],
+  onSkip: (reason: "malformed" | "empty", rule: string) => void,
+): void {
+  const length = css.length;
+  let start = 0;
+  while (start <= length) {
+    let end = css.indexOf(";", start);
+    if (end === -1) end = length;
+    let ruleStart = start;
+    let ruleEnd = end;
+    start = end + 1;
+    while (ruleStart < ruleEnd && isTrimmable(css.charCodeAt(ruleStart))) ruleStart++;
+    while (ruleEnd > ruleStart && isTrimmable(css.charCodeAt(ruleEnd - 1))) ruleEnd--;
+    if (ruleStart === ruleEnd) continue;
+
+    const colon = css.indexOf(":", ruleStart);
+    if (colon === -1 || colon >= ruleEnd) {
+      onSkip("malformed", css.slice(ruleStart, ruleEnd));
+      continue;
+    }
+    let keyEnd = colon;
+    while (keyEnd > ruleStart && isTrimmable(css.charCodeAt(keyEnd - 1))) keyEnd--;
+    let valueStart = colon + 1;
+    while (valueStart < ruleEnd && isTrimmable(css.charCodeAt(valueStart))) valueStart++;
+    if (keyEnd === ruleStart || valueStart === ruleEnd) {
+      onSkip("empty", css.slice(ruleStart, ruleEnd));
+      continue;
+    }
+
+    keys.push(hyphenate(css.slice(ruleStart, keyEnd)));
+    values.push(css.slice(valueStart, ruleEnd));
+  }
+}
+
 /**
  * # InlineStyle
  * @classdesc Create a CSS Inline style with protection levels.
@@ -37,19 +129,27 @@ export class InlineStyle {
 
   /**
    * ## constructor
-   * construct a InlineStyle with optional protection level
+   * construct a InlineStyle with optional protection level.
+   * `styleObject` is used as is, not copied: properties changed on it
+   * directly show up in `text` and `ansi`, until the first
+   * addStyleWithObject()/addStyleWithInlineCSS() merges it into a copy.
    */
   constructor(styleObject: { [key: string]: string }, protectionLevel?: ProtectionLevel) {
     if (protectionLevel && ["none", "boundary", "sandbox", "hardened"].includes(protectionLevel)) {
       this.#protectionLevel = protectionLevel;
     }
 
-    if (!JSTC.for([styleObject]).check(["object|undefined"])) {
+    if (!isObjectOrUndefined(styleObject)) {
       this.#handleInvalidStyleObject(styleObject);
       styleObject = { imeMode: `${styleObject}` };
     }
+    if (styleObject === undefined) styleObject = {};
     this.#styleObject = styleObject;
-    this.#cssStyleDec = new UUIII();
+    const seen = (this.#seen = new Map());
+    for (const prop of Object.keys(styleObject)) {
+      this.#dirty.add(prop);
+      seen.set(prop, styleObject[prop]);
+    }
   }
 
   #handleInvalidStyleObject(input: any): void {
@@ -62,172 +162,307 @@ export class InlineStyle {
         )
       );
     } else if (this.#protectionLevel === "sandbox") {
-      stylesheetWarner.warn({
-        message: formatStylesheetMessage(
-          "InlineStyle.constructor",
-          "Invalid style object.",
-          "Expected a plain object with CSS properties.",
-        ),
-      });
+      warnStylesheet(
+        "InlineStyle.constructor",
+        "Invalid style object.",
+        "Expected a plain object with CSS properties.",
+      );
     } else if (this.#protectionLevel === "boundary") {
-      stylesheetWarner.warn({
-        message: formatStylesheetMessage(
-          "InlineStyle.constructor",
-          "Invalid style object.",
-          "Expected a plain object with CSS properties.",
-          "Using a fallback style object.",
-        ),
-      });
+      warnStylesheet(
+        "InlineStyle.constructor",
+        "Invalid style object.",
+        "Expected a plain object with CSS properties.",
+        "Using a fallback style object.",
+      );
     }
   }
-  #cssStyleDec: UUIII;
+  /** Created by the first generate(); ANSI-only use never needs cssom. */
+  #cssStyleDec: UUIII | null = null;
+  /** Properties changed since the last generate(). */
+  #dirty = new Set<string>();
+  /** cssText of the last generate(), null when something changed since. */
+  #cssText: string | null = null;
+
+  /** serialize() result, null when something changed since. */
+  #serialized: string | null = null;
+  /** properties() result, null when something changed since. */
+  #properties: readonly string[] | null = null;
+
+  #version = 0;
+  /**
+   * Values last seen on the caller's object, to notice edits made to it
+   * directly; null once the style works on its own copy.
+   */
+  #seen: Map<string, unknown> | null = null;
+
+  /** Mark the properties the caller changed on the constructor's object. */
+  #detectEdits() {
+    const seen = this.#seen;
+    if (seen === null) return;
+    const b = this.#styleObject;
+    const props = Object.keys(b);
+    for (const prop of props) {
+      const val: unknown = b[prop];
+      if (seen.get(prop) === val && (val !== undefined || seen.has(prop))) continue;
+      seen.set(prop, val);
+      this.#markDirty(prop);
+    }
+    if (seen.size === props.length) return;
+    for (const prop of seen.keys()) {
+      if (Object.prototype.hasOwnProperty.call(b, prop)) continue;
+      seen.delete(prop);
+      this.#markDirty(prop);
+    }
+  }
+
+  #markDirty(prop: string) {
+    this.#dirty.add(prop);
+    this.#cssText = null;
+    this.#serialized = null;
+    this.#properties = null;
+    this.#version++;
+    styleEdits++;
+  }
+
+  /** Incremented by every change, so caches can tell whether the style changed. */
+  get version(): number {
+    this.#detectEdits();
+    return this.#version;
+  }
+
+  /**
+   * Hyphenated names of the properties this style sets; null and undefined
+   * values are left out, as generate() skips them.
+   */
+  properties(): readonly string[] {
+    this.#detectEdits();
+    if (this.#properties !== null) return this.#properties;
+    const b = this.#styleObject;
+    const out: string[] = [];
+    for (const prop of Object.keys(b)) {
+      if (b[prop] != null) out.push(hyphenate(prop));
+    }
+    return (this.#properties = out);
+  }
+
+  /**
+   * Stable text form of the raw style object (property order included),
+   * from which generate() is fully determined. Used for content hashes;
+   * touches neither cssom nor the cached cssText.
+   */
+  serialize(): string {
+    this.#detectEdits();
+    if (this.#serialized !== null) return this.#serialized;
+    let out = "";
+    const b = this.#styleObject;
+    for (const prop of Object.keys(b)) {
+      const val: unknown = b[prop];
+      // Length prefixes keep the encoding unambiguous whatever the values contain.
+      const text = val == null ? "~" : `${String(val).length}:${String(val)}`;
+      out += `${prop.length}:${prop}=${text};`;
+    }
+    return (this.#serialized = out);
+  }
+
+  /**
+   * Generate the cssText of this style.
+   * Only properties changed since the last call are pushed to the declaration;
+   * an unchanged style returns the cached text.
+   */
   generate() {
-    let a = this.#cssStyleDec;
-    let b = this.#styleObject;
-    let c = Object.keys(b);
-    let d = Object.values(b);
-    for (let i = 0; i < c.length; i++) {
-      const prop = c[i];
-      let val = d[i];
+    this.#detectEdits();
+    if (this.#cssText !== null) return this.#cssText;
+    const a = (this.#cssStyleDec ??= new UUIII());
+    const b = this.#styleObject;
+    for (const prop of this.#dirty) {
+      if (!Object.prototype.hasOwnProperty.call(b, prop)) {
+        a.removeProperty(prop);
+        continue;
+      }
+      let val: unknown = b[prop];
       if (val == null) {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
+        warnStylesheet(
           "InlineStyle.generate",
           `Skipping property "${prop}" with ${JSON.stringify(val)} value.`,
           "Avoid null or undefined style values.",
-        )});
+        );
+        a.removeProperty(prop);
         continue;
       }
       if (typeof val !== "string") {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
+        warnStylesheet(
           "InlineStyle.generate",
           `Non-string style value for "${prop}" (type=${typeof val}).`,
           "Provide style values as strings.",
           "Coercing value to string.",
-        )});
+        );
         val = String(val);
       }
-      a.setProperty(prop, val);
+      a.setProperty(prop, val as string);
     }
-    return a.cssText;
+    this.#dirty.clear();
+    this.#cssText = a.cssText;
+    return this.#cssText;
   }
   get text() {
     return this.generate();
   }
 
+  /**
+   * ANSI prefix for this style (bold, underline, color, background-color).
+   * Memoized on the raw values it depends on, so repeated access does no color parsing.
+   */
   get ansi(): string {
+    return this.ansiWith();
+  }
+
+  /**
+   * ansi with every raw value it reads passed through `resolve` first.
+   * StyleSheet#ansi uses it to substitute design tokens.
+   */
+  ansiWith(resolve?: (value: string) => string): string {
     const s: any = this.#styleObject || {};
+    const read = (value: unknown) => (resolve && typeof value === "string" ? resolve(value) : value);
+    const bold = read(s["font-weight"]) === "bold" || read(s.fontWeight) === "bold";
+    const underline = (read(s["text-decoration"]) || read(s.textDecoration) || "").includes("underline");
+    const colorVal = read(s.color || s["color"]);
+    const bgVal = read(s["background-color"] || s.backgroundColor);
+
+    const memo = this.#ansiMemo;
+    if (
+      memo &&
+      memo.bold === bold &&
+      memo.underline === underline &&
+      memo.colorVal === colorVal &&
+      memo.bgVal === bgVal
+    ) {
+      return memo.ansi;
+    }
+
     let parts: string[] = [];
 
-    if (s["font-weight"] === "bold" || s.fontWeight === "bold") parts.push(Color.BOLD);
-    if ((s["text-decoration"] || s.textDecoration || "").includes("underline")) parts.push(Color.UNDERLINE);
+    if (bold) parts.push(Color.BOLD);
+    if (underline) parts.push(Color.UNDERLINE);
 
-    const colorVal = s.color || s["color"];
     if (colorVal) {
       try {
         const c = new Color(String(colorVal));
         parts.push(c.ansiTruecolor());
       } catch (e) {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
+        warnStylesheet(
           "InlineStyle.ansi",
           `Invalid color value "${JSON.stringify(colorVal)}".`,
           "Use a valid hex, rgb(), hsl(), or named color.",
           "Ignoring this color value.",
-        )});
+        );
       }
     }
 
-    const bgVal = s["background-color"] || s.backgroundColor;
     if (bgVal) {
       try {
         const c = new Color(String(bgVal));
         parts.push(c.ansiTruecolorBg());
       } catch (e) {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
+        warnStylesheet(
           "InlineStyle.ansi",
           `Invalid background-color value "${JSON.stringify(bgVal)}".`,
           "Use a valid hex, rgb(), hsl(), or named color.",
           "Ignoring this background color value.",
-        )});
+        );
       }
     }
 
-    return parts.join("");
+    const ansi = parts.join("");
+    this.#ansiMemo = { bold, underline, colorVal, bgVal, ansi };
+    return ansi;
   }
+  #ansiMemo?: { bold: boolean; underline: boolean; colorVal: unknown; bgVal: unknown; ansi: string };
 
   addStyleWithObject(styleObject: object) {
-    if (!JSTC.for([styleObject]).check(["object"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "InlineStyle.addStyleWithObject",
-          "Invalid first argument.",
-          `Expected a plain object with CSS properties. Received: ${JSON.stringify(styleObject)}.`,
-          "Returning without changes.",
-        )});
+    if (!isObject(styleObject)) {
+      warnStylesheet(
+        "InlineStyle.addStyleWithObject",
+        "Invalid first argument.",
+        `Expected a plain object with CSS properties. Received: ${JSON.stringify(styleObject)}.`,
+        "Returning without changes.",
+      );
       return this;
     }
-    this.#styleObject = { ...this.#styleObject, ...styleObject };
-    this.generate();
+    const added = styleObject as { [key: string]: string };
+    if (this.#seen !== null) {
+      // Like before caching: the first merge detaches from the caller's object.
+      this.#detectEdits();
+      this.#styleObject = { ...this.#styleObject };
+      this.#seen = null;
+    }
+    for (const prop of Object.keys(added ?? {})) {
+      this.#styleObject[prop] = added[prop];
+      this.#markDirty(prop);
+    }
     return this;
   }
   addStyleWithInlineCSS(inlineCSS: string) {
-    if (!JSTC.for([inlineCSS]).check(["string"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
+    if (!isString(inlineCSS)) {
+      warnStylesheet(
         "InlineStyle.addStyleWithInlineCSS",
         "Invalid first argument.",
         "The first argument must be a valid inline CSS string.",
         "Returning without changes.",
-      )});
+      );
       return this;
     }
-    let s = new UUIII();
-    s.cssText = this.#convertKeysToValidCSS(inlineCSS);
+
+    let keys: string[] = [];
+    let values: string[] = [];
+    const tokens = native?.tokenize(inlineCSS);
+    if (tokens) {
+      [keys, values] = tokens;
+      for (const rule of tokens[2]) this.#warnSkippedRule("malformed", rule);
+      for (const rule of tokens[3]) this.#warnSkippedRule("empty", rule);
+    } else {
+      tokenizeInlineCSS(inlineCSS, keys, values, (reason, rule) => this.#warnSkippedRule(reason, rule));
+    }
+
     let o: { [key: string]: string } = {};
-    for (let i: number = 0; i < s.length; i++) {
-      const a = s[i];
-      const v = s.getPropertyValue(a);
-      o[a] = v;
+    if (this.#protectionLevel === "none") {
+      for (let i = 0; i < keys.length; i++) o[keys[i]] = values[i];
+    } else {
+      // Let cssom normalize the declarations.
+      let cssText = "";
+      for (let i = 0; i < keys.length; i++) cssText += `${keys[i]}:${values[i]};`;
+      let s = new UUIII();
+      s.cssText = cssText;
+      for (let i: number = 0; i < s.length; i++) {
+        const a = s[i];
+        const v = s.getPropertyValue(a);
+        o[a] = v;
+      }
     }
     this.addStyleWithObject(o);
     return this;
   }
-  #convertFieldToHyphenCase(string: string) {
-    return string.replace(/([A-Z])/g, (match) => `-${match.toLowerCase()}`);
-  }
-  #convertKeysToValidCSS(string: string) {
-    const parts = string.split(";");
-    let out = "";
-    for (let i = 0; i < parts.length; i++) {
-      const raw = parts[i].trim();
-      if (!raw) continue;
-      const kv = raw.split(":");
-      if (kv.length < 2) {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
-            "InlineStyle.convertKeysToValidCSS",
-            `Skipping malformed rule: "${raw}".`,
-            'Expected "property: value" pairs separated by ";".',
-          )});
-        continue;
-      }
-      const k = kv[0].trim();
-      const v = kv.slice(1).join(":").trim();
-      if (!k || !v) {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
-          "InlineStyle.convertKeysToValidCSS",
-          `Skipping empty property or value in rule: "${raw}".`,
-        )});
-        continue;
-      }
-      out += `${this.#convertFieldToHyphenCase(k)}:${v};`;
+  #warnSkippedRule(reason: "malformed" | "empty", rule: string) {
+    if (reason === "malformed") {
+      warnStylesheet(
+        "InlineStyle.convertKeysToValidCSS",
+        `Skipping malformed rule: "${rule}".`,
+        'Expected "property: value" pairs separated by ";".',
+      );
+    } else {
+      warnStylesheet(
+        "InlineStyle.convertKeysToValidCSS",
+        `Skipping empty property or value in rule: "${rule}".`,
+      );
     }
-    return out;
   }
   removeStyle(styles: string[] | string) {
-    if (!JSTC.for([styles]).check(["string[]|string"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "InlineStyle.removeStyle",
-          "Invalid first argument.",
-          `Expected a string or an array of strings. Received: ${JSON.stringify(styles)}.`,
-          "Returning without changes.",
-        )});
+    if (!isStringOrStringArray(styles)) {
+      warnStylesheet(
+        "InlineStyle.removeStyle",
+        "Invalid first argument.",
+        `Expected a string or an array of strings. Received: ${JSON.stringify(styles)}.`,
+        "Returning without changes.",
+      );
       return this;
     }
     if (typeof styles === "string") {
@@ -236,33 +471,35 @@ export class InlineStyle {
     for (let i: number = 0; i < styles.length; i++) {
       const prop = styles[i];
       if (typeof prop !== "string") {
-        stylesheetWarner.warn({message: formatStylesheetMessage(
-            "InlineStyle.removeStyle",
-            `Ignoring non-string style name at index ${i}: ${JSON.stringify(prop)}.`,
-          )});
+        warnStylesheet(
+          "InlineStyle.removeStyle",
+          `Ignoring non-string style name at index ${i}: ${JSON.stringify(prop)}.`,
+        );
         continue;
       }
       delete this.#styleObject[prop];
+      this.#seen?.delete(prop);
+      this.#markDirty(prop);
     }
     return this;
   }
   applyTo(element: HTMLElement) {
-    if (!JSTC.for([element]).check(["object"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "InlineStyle.applyTo",
-          "Invalid first argument.",
-          "Expected an HTMLElement.",
-          "No operation was performed.",
-        )});
+    if (!isObject(element)) {
+      warnStylesheet(
+        "InlineStyle.applyTo",
+        "Invalid first argument.",
+        "Expected an HTMLElement.",
+        "No operation was performed.",
+      );
       return this;
     }
     if (!element || typeof (element as any).style !== "object") {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "InlineStyle.applyTo",
-          "The given object does not look like an HTMLElement (missing .style).",
-          undefined,
-          "No operation was performed.",
-        )});
+      warnStylesheet(
+        "InlineStyle.applyTo",
+        "The given object does not look like an HTMLElement (missing .style).",
+        undefined,
+        "No operation was performed.",
+      );
       return this;
     }
     element.style.cssText = this.generate();
@@ -272,11 +509,128 @@ export class InlineStyle {
   #styleObject: { [key: string]: string };
 }
 
+let utf8Encoder: TextEncoder | undefined;
+
+/**
+ * Mixed into every StyleSheet#hash(). Bump it whenever the CSS generated for
+ * the same inputs changes, so caches written by older versions miss.
+ */
+const STYLESHEET_HASH_FORMAT = "briklab-stylesheet/1";
+
+/** The part of a Node.js `Writable` (e.g. an `http.ServerResponse`) that generateTo() uses. */
+export interface StyleSheetWritable {
+  write(chunk: string): boolean;
+  once(event: "drain" | "error" | "close", listener: (...args: any[]) => void): unknown;
+  removeListener(event: "drain" | "error" | "close", listener: (...args: any[]) => void): unknown;
+  readonly destroyed?: boolean;
+}
+
+/** Resolves on "drain"; rejects when the stream errors or closes first. */
+function drained(stream: StyleSheetWritable): Promise<void> {
+  return new Promise((resolve, reject) => {
+    const done = (error?: unknown) => {
+      stream.removeListener("drain", onDrain);
+      stream.removeListener("error", onError);
+      stream.removeListener("close", onClose);
+      if (error === undefined) resolve();
+      else reject(error);
+    };
+    const onDrain = () => done();
+    const onError = (error: unknown) => done(error ?? new Error("stream error"));
+    const onClose = () =>
+      done(
+        new Error(
+          formatStylesheetMessage(
+            "StyleSheet.generateTo",
+            "The stream closed before the stylesheet was written.",
+          ),
+        ),
+      );
+    // A destroyed stream has already emitted "close" and will not drain.
+    if (stream.destroyed) return onClose();
+    stream.once("drain", onDrain);
+    stream.once("error", onError);
+    stream.once("close", onClose);
+  });
+}
+
 export class StyleSheet {
-  constructor() {
-    this.#styles = {};
+  /** Rules in insertion (cascade) order, indexed by name and by property. */
+  #rules = new RuleStore<InlineStyle>((style) => style.properties());
+  /** generate() result, null when a rule or token changed since. */
+  #cssText: string | null = null;
+  /** Design tokens, referenced from style values as `var(--name)`. */
+  #tokens = new TokenGraph<InlineStyle>((name, reason) =>
+    warnStylesheet(
+      "StyleSheet.defineToken",
+      `Token "${name}" cannot be resolved: ${reason}.`,
+      undefined,
+      "Its var() references are left as they are.",
+    ),
+  );
+  /** cssText and ansi with tokens substituted, for styles that reference tokens. */
+  #resolvedText = new Map<InlineStyle, string>();
+  #resolvedAnsi = new Map<InlineStyle, string>();
+
+  /** Every stored style: the version last synced and how many rules use it. */
+  #styles = new Map<InlineStyle, { version: number; rules: number }>();
+  /** styleEdits as of the last #sync(). */
+  #synced = styleEdits;
+
+  /** Brings the index and cached text up to date with changed styles. */
+  #sync(): void {
+    if (this.#synced === styleEdits) return;
+    this.#synced = styleEdits;
+    for (const [style, seen] of this.#styles) {
+      if (seen.version === style.version) continue;
+      seen.version = style.version;
+      this.#cssText = null;
+      this.#rules.changed(style);
+      this.#forget(style);
+    }
+  }
+
+  #use(style: InlineStyle): void {
+    const seen = this.#styles.get(style);
+    if (seen) seen.rules++;
+    else this.#styles.set(style, { version: style.version, rules: 1 });
+  }
+
+  /** Drop one rule's use of `style`, forgetting it once no rule uses it. */
+  #release(style: InlineStyle): void {
+    const seen = this.#styles.get(style);
+    if (seen && --seen.rules > 0) return;
+    this.#styles.delete(style);
+    this.#forget(style);
+  }
+
+  #forget(style: InlineStyle): void {
+    this.#resolvedText.delete(style);
+    this.#resolvedAnsi.delete(style);
+    this.#tokens.untrack(style);
+  }
+
+  #tokensChanged(affected: Set<InlineStyle>): void {
+    for (const style of affected) {
+      this.#resolvedText.delete(style);
+      this.#resolvedAnsi.delete(style);
+    }
+    this.#cssText = null;
+  }
+
+  /** cssText of `style` with this sheet's tokens substituted. */
+  #textOf(style: InlineStyle): string {
+    const text = style.text;
+    if (this.#tokens.size === 0) return text;
+    const cached = this.#resolvedText.get(style);
+    if (cached !== undefined) return cached;
+    const names: string[] = [];
+    const resolved = this.#tokens.substitute(text, (name) => names.push(name));
+    if (names.length === 0) return text;
+    this.#tokens.track(style, names);
+    this.#resolvedText.set(style, resolved);
+    return resolved;
   }
-#styles: { [key: string]: InlineStyle } 
 
   /**
    * Add or update a rule in the stylesheet.
@@ -284,26 +638,32 @@ export class StyleSheet {
    * @param style An InlineStyle instance.
    */
   set(name: string, style: InlineStyle) {
-    if (!JSTC.for([name, style]).check(["string", "object"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "StyleSheet.set",
-          "Invalid arguments.",
-          `Call .set("ruleName", new InlineStyle({...})). Received name=${JSON.stringify(name)}, style=${JSON.stringify(style)}.`,
-          "Returning without changes.",
-        )});
+    if (!isNameAndObject(name, style)) {
+      warnStylesheet(
+        "StyleSheet.set",
+        "Invalid arguments.",
+        `Call .set("ruleName", new InlineStyle({...})). Received name=${JSON.stringify(name)}, style=${JSON.stringify(style)}.`,
+        "Returning without changes.",
+      );
       return this;
     }
     if (!(style instanceof InlineStyle)) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "StyleSheet.set",
-          "The provided style is not an InlineStyle instance.",
-          `Create the style with new InlineStyle({...}). Received: ${JSON.stringify(style)}.`,
-          "Returning without changes.",
-        )});
+      warnStylesheet(
+        "StyleSheet.set",
+        "The provided style is not an InlineStyle instance.",
+        `Create the style with new InlineStyle({...}). Received: ${JSON.stringify(style)}.`,
+        "Returning without changes.",
+      );
       return this;
     }
 
-    this.#styles[name] = style;
+    const previous = this.#rules.get(name);
+    this.#rules.set(name, style);
+    if (previous !== style) {
+      this.#use(style);
+      if (previous) this.#release(previous);
+    }
+    this.#cssText = null;
     return this;
   }
 
@@ -311,47 +671,240 @@ export class StyleSheet {
    * Get a rule by name.
    */
   get(name: string) {
-    if (!JSTC.for([name]).check(["string"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "StyleSheet.get",
-          "Invalid argument.",
-          `Name must be a string. Received: ${JSON.stringify(name)}.`,
-          "Returning undefined.",
-        )});
+    if (!isString(name)) {
+      warnStylesheet(
+        "StyleSheet.get",
+        "Invalid argument.",
+        `Name must be a string. Received: ${JSON.stringify(name)}.`,
+        "Returning undefined.",
+      );
       return undefined;
     }
-    return this.#styles[name];
+    return this.#rules.get(name);
   }
 
   /**
    * Remove a rule by name.
    */
   remove(name: string) {
-    if (!JSTC.for([name]).check(["string"])) {
-      stylesheetWarner.warn({message: formatStylesheetMessage(
-          "StyleSheet.remove",
-          "Invalid argument.",
-          `Name must be a string. Received: ${JSON.stringify(name)}.`,
-          "No operation was performed.",
-        )});
+    if (!isString(name)) {
+      warnStylesheet(
+        "StyleSheet.remove",
+        "Invalid argument.",
+        `Name must be a string. Received: ${JSON.stringify(name)}.`,
+        "No operation was performed.",
+      );
+      return this;
+    }
+    const style = this.#rules.get(name);
+    if (style && this.#rules.delete(name)) {
+      this.#release(style);
+      this.#cssText = null;
+    }
+    return this;
+  }
+
+  /**
+   * Define or replace a design token, referenced from style values as
+   * `var(--name)`. The value is CSS text (which may reference other
+   * tokens), a Color, or a function deriving one from other tokens, e.g.
+   * `(token) => new Color({ ...new Color(token("brand")!).rgbaObj(), a: 0.5 })`.
+   * Only the rules and tokens that depend on `name` are recomputed; rules
+   * never rerun cssom for a token change.
+   */
+  defineToken(name: string, value: TokenDefinition) {
+    if (!isString(name) || tokenName(name).length === 0) {
+      warnStylesheet(
+        "StyleSheet.defineToken",
+        "Invalid token name.",
+        `Expected a non-empty string such as "brand" or "--brand". Received: ${JSON.stringify(name)}.`,
+        "Returning without changes.",
+      );
+      return this;
+    }
+    if (typeof value !== "string" && typeof value !== "function" && !(value instanceof Color)) {
+      warnStylesheet(
+        "StyleSheet.defineToken",
+        `Invalid value for token "${name}".`,
+        "Expected a CSS string, a Color or a function returning one.",
+        "Returning without changes.",
+      );
       return this;
     }
-    delete this.#styles[name];
+    this.#tokensChanged(this.#tokens.define(tokenName(name), value));
     return this;
   }
 
+  /**
+   * Remove a design token; its references are emitted as written again.
+   */
+  removeToken(name: string) {
+    if (!isString(name)) {
+      warnStylesheet(
+        "StyleSheet.removeToken",
+        "Invalid argument.",
+        `Name must be a string. Received: ${JSON.stringify(name)}.`,
+        "No operation was performed.",
+      );
+      return this;
+    }
+    this.#tokensChanged(this.#tokens.delete(tokenName(name)));
+    return this;
+  }
+
+  /**
+   * Resolved value of a token: a Color, or CSS text with other tokens
+   * substituted. `undefined` when it is not defined or cannot be resolved.
+   */
+  token(name: string): TokenValue | undefined {
+    if (!isString(name)) {
+      warnStylesheet(
+        "StyleSheet.token",
+        "Invalid argument.",
+        `Name must be a string. Received: ${JSON.stringify(name)}.`,
+        "Returning undefined.",
+      );
+      return undefined;
+    }
+    return this.#tokens.value(tokenName(name));
+  }
+
+  /**
+   * ANSI prefix of rule `name` (see InlineStyle#ansi) with tokens resolved,
+   * or "" when there is no such rule. Cached until the rule or a token it
+   * uses changes.
+   */
+  ansi(name: string): string {
+    if (!isString(name)) {
+      warnStylesheet(
+        "StyleSheet.ansi",
+        "Invalid argument.",
+        `Name must be a string. Received: ${JSON.stringify(name)}.`,
+        'Returning "".',
+      );
+      return "";
+    }
+    const style = this.#rules.get(name);
+    if (!style) return "";
+    if (this.#tokens.size === 0) return style.ansi;
+    this.#sync();
+    const cached = this.#resolvedAnsi.get(style);
+    if (cached !== undefined) return cached;
+    const names: string[] = [];
+    const ansi = style.ansiWith((value) => this.#tokens.substitute(value, (token) => names.push(token)));
+    if (names.length > 0) {
+      this.#tokens.track(style, names);
+      this.#resolvedAnsi.set(style, ansi);
+    }
+    return ansi;
+  }
+
+  /**
+   * Names of the rules that set `property` (camelCase or hyphenated), in
+   * stylesheet order. Served from an index kept current as styles change,
+   * so the cost depends on the number of matches, not the sheet size.
+   */
+  rulesWith(property: string): string[] {
+    if (!isString(property)) {
+      warnStylesheet(
+        "StyleSheet.rulesWith",
+        "Invalid argument.",
+        `Property must be a string. Received: ${JSON.stringify(property)}.`,
+        "Returning an empty list.",
+      );
+      return [];
+    }
+    this.#sync();
+    return this.#rules.withProperty(hyphenate(property));
+  }
+
+  /**
+   * 64-bit content hash (16 hex digits) of the rule names and raw style
+   * objects, in order, plus the resolved tokens. Sheets built from the same inputs hash the same in
+   * any process, with or without the native addon, and no CSS is generated.
+   * This is the key StyleSheetCache stores generated CSS under.
+   */
+  hash(): string {
+    let source = STYLESHEET_HASH_FORMAT;
+    this.#rules.forEach((key, style) => {
+      source += `\n${key.length}:${key}\n${style.serialize()}`;
+    });
+    for (const [name, text] of this.#tokens.entries()) {
+      source += `\n--${name.length}:${name}=${text === undefined ? "~" : `${text.length}:${text}`}`;
+    }
+    return hash64(source);
+  }
+
   /**
    * Generate CSS text for the whole stylesheet.
+   * `var(--name)` references to defined tokens are substituted. The result
+   * is cached until a rule or token is set, removed or changed; after a
+   * change only changed styles regenerate their text, so the cost is one
+   * concatenation per rule. A style object edited directly (rather than
+   * through InlineStyle methods) is noticed once that style is read again,
+   * e.g. through `style.text`.
    */
   generate(): string {
+    this.#sync();
+    if (this.#cssText !== null) return this.#cssText;
     let css = "";
-    for (const key in this.#styles) {
-      const style = this.#styles[key];
-      if (style) {
-        css += `${key} { ${style.text} }\n`;
+    this.#rules.forEach((key, style) => {
+      css += `${key} { ${this.#textOf(style)} }\n`;
+    });
+    // Same result as css.trim(): the text always ends in "}\n" and only the
+    // first selector can start with whitespace.
+    return (this.#cssText =
+      css.length > 0 && isTrimmable(css.charCodeAt(0)) ? css.trim() : css.slice(0, -1));
+  }
+
+  /**
+   * Generate the stylesheet as UTF-8 bytes, ready for `fs.write` or an HTTP
+   * response. Same content as generate().
+   */
+  generateBytes(): Uint8Array {
+    return (utf8Encoder ??= new TextEncoder()).encode(this.generate());
+  }
+
+  /**
+   * Write the stylesheet to `stream` in chunks of about `chunkSize` UTF-16
+   * code units (default 16384), waiting for "drain" whenever `write()`
+   * returns false. The output equals generate(), but only one chunk is held
+   * in memory and the first bytes go out after the first chunk. The stream
+   * is not ended. Rules set or removed while the returned promise is pending
+   * may or may not be included.
+   */
+  async generateTo(stream: StyleSheetWritable, options?: { chunkSize?: number }): Promise<void> {
+    if (!stream || typeof stream.write !== "function" || typeof stream.once !== "function") {
+      warnStylesheet(
+        "StyleSheet.generateTo",
+        "Invalid first argument.",
+        "Expected a Writable stream (write(), once() and removeListener()).",
+        "No operation was performed.",
+      );
+      return;
+    }
+    const requested = options?.chunkSize;
+    const chunkSize = typeof requested === "number" && requested >= 1 ? requested : 16384;
+
+    this.#sync();
+    let chunk = "";
+    let first = true;
+    for (const [key, style] of this.#rules) {
+      let rule = `${key} { ${this.#textOf(style)} }`;
+      if (first) {
+        if (isTrimmable(rule.charCodeAt(0))) rule = rule.trimStart();
+        chunk = rule;
+        first = false;
+      } else {
+        chunk += `\n${rule}`;
+      }
+      if (chunk.length >= chunkSize) {
+        const ready = stream.write(chunk);
+        chunk = "";
+        if (!ready) await drained(stream);
       }
     }
-    return css.trim();
+    if (chunk.length > 0 && !stream.write(chunk)) await drained(stream);
   }
 
   /**
@@ -0,0 +1,24 @@
+/**
+ * # @briklab/lib/stylesheet/node
+ * Typed access to the optional native stylesheet addon.
+ * `native` is `null` when the addon is not built or cannot be loaded.
+ */
+
+export interface StylesheetNativeAddon {
+  abiVersion: number;
+  /**
+   * Tokenize inline CSS in one pass.
+   * Returns `[keys, values, malformedRules, emptyRules]` with hyphenated keys,
+   * or `undefined` when the TS tokenizer has to handle the input.
+   */
+  tokenize(css: string): [string[], string[], string[], string[]] | undefined;
+  /** 64-bit content hash of the UTF-8 bytes of `text`, as 16 hex digits; see src/stylesheet/hash.ts. */
+  hash(text: string): string | undefined;
+  /**
+   * Bytes of the file at `path` over a copy-on-write memory mapping, or
+   * `undefined` when it cannot be mapped (always on Windows).
+   */
+  mapFile(path: string): Uint8Array | undefined;
+}
+
+export { native } from "../index.js";
@@ -0,0 +1,172 @@
+// Node-API kernels of the stylesheet module.
+//
+// Linked into the briklab_core addon (src/native/binding.gyp), which exposes
+// them as `core.stylesheet`.
+
+#include <node_api.h>
+
+#include <string>
+#include <string_view>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "arena.hpp"
+#include "core.hpp"
+#include "hash.hpp"
+#include "napi_util.hpp"
+#include "tokenize.hpp"
+
+namespace {
+
+using briklab::napi::readString;
+
+napi_status push(napi_env env, napi_value array, uint32_t& length, std::string_view text) {
+  napi_value value;
+  napi_status status = napi_create_string_utf8(env, text.data(), text.size(), &value);
+  if (status != napi_ok) return status;
+  return napi_set_element(env, array, length++, value);
+}
+
+// Property names repeat across calls, so they come from the env's cache.
+napi_status pushName(napi_env env, napi_value array, uint32_t& length, std::string_view name) {
+  briklab::EnvData* data = briklab::envData(env);
+  if (data == nullptr) return push(env, array, length, name);
+  napi_value value;
+  napi_status status = data->strings.get(env, name, &value);
+  if (status != napi_ok) return status;
+  return napi_set_element(env, array, length++, value);
+}
+
+// tokenize(css: string): [keys, values, malformed, empty] | undefined
+// Parallel key/value arrays plus the rules that were skipped, by reason.
+// Returns undefined when the TS tokenizer has to handle the input.
+napi_value Tokenize(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  napi_value undefined;
+  BRIKLAB_CALL(env, napi_get_undefined(env, &undefined));
+  thread_local std::string css;
+  if (argc < 1 || !readString(env, argv[0], css)) return undefined;
+
+  napi_value lists[4];
+  uint32_t lengths[4] = {0, 0, 0, 0};
+  for (napi_value& list : lists) BRIKLAB_CALL(env, napi_create_array(env, &list));
+
+  napi_status status = napi_ok;
+  const bool handled = briklab::stylesheet::tokenize(
+      css,
+      [&](std::string_view key, std::string_view value) {
+        if (status != napi_ok) return;
+        status = pushName(env, lists[0], lengths[0], key);
+        if (status == napi_ok) status = push(env, lists[1], lengths[1], value);
+      },
+      [&](briklab::stylesheet::Skip reason, std::string_view rule) {
+        if (status != napi_ok) return;
+        const int slot = reason == briklab::stylesheet::Skip::Malformed ? 2 : 3;
+        status = push(env, lists[slot], lengths[slot], rule);
+      });
+  BRIKLAB_CALL(env, status);
+  if (!handled) return undefined;
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_create_array_with_length(env, 4, &result));
+  for (uint32_t i = 0; i < 4; i++) BRIKLAB_CALL(env, napi_set_element(env, result, i, lists[i]));
+  return result;
+}
+
+// hash(text: string): string | undefined
+// hash64() of the UTF-8 bytes of `text` as 16 hex digits; undefined for
+// non-strings.
+napi_value Hash(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_get_undefined(env, &result));
+  briklab::ScratchScope scope;
+  std::string_view text;
+  if (argc < 1 || !readString(env, argv[0], scope.arena(), text)) return result;
+
+  char hex[16];
+  briklab::hash::toHex(briklab::hash::hash64(text.data(), text.size()), hex);
+  BRIKLAB_CALL(env, napi_create_string_latin1(env, hex, sizeof(hex), &result));
+  return result;
+}
+
+#if !defined(_WIN32)
+void unmap(napi_env, void* data, void* hint) {
+  munmap(data, reinterpret_cast<size_t>(hint));
+}
+#endif
+
+// mapFile(path: string): Buffer | undefined
+// The file's bytes as a Buffer over a private, copy-on-write mapping, so it
+// is paged in on demand and writes to the Buffer never reach the file.
+// Falls back to a copy where external buffers are not allowed. undefined
+// when the file cannot be opened or mapped, and always on Windows.
+napi_value MapFile(napi_env env, napi_callback_info info) {
+  size_t argc = 1;
+  napi_value argv[1];
+  BRIKLAB_CALL(env, napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr));
+
+  napi_value result;
+  BRIKLAB_CALL(env, napi_get_undefined(env, &result));
+#if !defined(_WIN32)
+  briklab::ScratchScope scope;
+  std::string_view path;
+  if (argc < 1 || !readString(env, argv[0], scope.arena(), path)) return result;
+
+  const int fd = open(path.data(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return result;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+    close(fd);
+    return result;
+  }
+  const auto size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    close(fd);
+    void* data = nullptr;
+    BRIKLAB_CALL(env, napi_create_buffer(env, 0, &data, &result));
+    return result;
+  }
+  void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) return result;
+
+  if (napi_create_external_buffer(env, size, data, unmap, reinterpret_cast<void*>(size), &result) ==
+      napi_ok) {
+    return result;
+  }
+  const napi_status status = napi_create_buffer_copy(env, size, data, nullptr, &result);
+  munmap(data, size);
+  BRIKLAB_CALL(env, status);
+#endif
+  return result;
+}
+
+}  // namespace
+
+namespace briklab::stylesheet {
+
+napi_value Init(napi_env env, napi_value exports) {
+  BRIKLAB_CALL(env, briklab::napi::exportAbiVersion(env, exports));
+
+  napi_property_descriptor props[] = {
+      {"tokenize", nullptr, Tokenize, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"hash", nullptr, Hash, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+      {"mapFile", nullptr, MapFile, nullptr, nullptr, nullptr, napi_enumerable, nullptr},
+  };
+  BRIKLAB_CALL(env, napi_define_properties(env, exports, sizeof(props) / sizeof(*props), props));
+  return exports;
+}
+
+}  // namespace briklab::stylesheet
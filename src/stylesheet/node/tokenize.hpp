@@ -0,0 +1,78 @@
+// Single-pass inline CSS tokenizer behind InlineStyle#addStyleWithInlineCSS.
+//
+// Splits "prop: value; other: value" into declarations the same way
+// tokenizeInlineCSS in src/stylesheet/index.ts does: rules are separated by
+// ';', the key is everything before the first ':', camelCase keys are
+// hyphenated and both sides are trimmed. Only ASCII input is handled; the
+// caller falls back to the TS tokenizer otherwise.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "simd.hpp"
+
+namespace briklab::stylesheet {
+
+enum class Skip { Malformed, Empty };
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline std::string_view trim(std::string_view s) {
+  while (!s.empty() && isSpace(s.front())) s.remove_prefix(1);
+  while (!s.empty() && isSpace(s.back())) s.remove_suffix(1);
+  return s;
+}
+
+// camelCase -> camel-case, appended to `out`.
+inline void appendHyphenated(std::string_view key, std::string& out) {
+  for (char c : key) {
+    if (c >= 'A' && c <= 'Z') {
+      out.push_back('-');
+      out.push_back(static_cast<char>(c - 'A' + 'a'));
+    } else {
+      out.push_back(c);
+    }
+  }
+}
+
+// Calls onDeclaration(std::string_view key, std::string_view value) for every
+// declaration and onSkip(Skip, std::string_view rule) for rules that are
+// dropped. `key` is only valid during the call. Returns false, without calling
+// anything, when `css` is not ASCII.
+template <typename OnDeclaration, typename OnSkip>
+bool tokenize(std::string_view css, OnDeclaration&& onDeclaration, OnSkip&& onSkip) {
+  if (!simd::isAscii(css)) return false;
+
+  std::string key;
+  std::size_t start = 0;
+  while (start <= css.size()) {
+    std::size_t end = css.find(';', start);
+    if (end == std::string_view::npos) end = css.size();
+    const std::string_view rule = trim(css.substr(start, end - start));
+    start = end + 1;
+    if (rule.empty()) continue;
+
+    const std::size_t colon = rule.find(':');
+    if (colon == std::string_view::npos) {
+      onSkip(Skip::Malformed, rule);
+      continue;
+    }
+    const std::string_view rawKey = trim(rule.substr(0, colon));
+    const std::string_view value = trim(rule.substr(colon + 1));
+    if (rawKey.empty() || value.empty()) {
+      onSkip(Skip::Empty, rule);
+      continue;
+    }
+    key.clear();
+    appendHyphenated(rawKey, key);
+    onDeclaration(std::string_view(key), value);
+  }
+  return true;
+}
+
+}  // namespace briklab::stylesheet
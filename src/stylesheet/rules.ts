@@ -0,0 +1,164 @@
+/**
+ * # RuleStore
+ * Rule storage behind StyleSheet.
+ *
+ * Rules live in dense parallel arrays in insertion order, which is also
+ * cascade order, with a name -> slot map on top. Removing a rule leaves a
+ * tombstone that iteration skips; once tombstones outnumber live rules the
+ * arrays are compacted in one pass. An inverted index maps each CSS
+ * property to the names of the rules that set it, so property queries cost
+ * O(k log k) in the number of matching rules instead of a full scan. The
+ * index is built by the first query and maintained from then on, so sheets
+ * that are never queried do not pay for it.
+ */
+
+/** Tombstones tolerated before compaction is considered at all. */
+const MIN_TOMBSTONES = 32;
+
+export class RuleStore<S extends object> {
+  #names: string[] = [];
+  /** `undefined` marks a removed rule. */
+  #styles: (S | undefined)[] = [];
+  #slots = new Map<string, number>();
+  #dead = 0;
+  #propertiesOf: (style: S) => readonly string[];
+  /** property -> rule names; null until the first withProperty(). */
+  #byProperty: Map<string, Set<string>> | null = null;
+  /** What each rule is indexed under, to undo on reindex/delete. */
+  #indexedAs = new Map<string, readonly string[]>();
+  /** style -> rule names, kept alongside #byProperty for changed(). */
+  #namesOf = new Map<S, Set<string>>();
+
+  /** @param propertiesOf The property names a style sets. */
+  constructor(propertiesOf: (style: S) => readonly string[]) {
+    this.#propertiesOf = propertiesOf;
+  }
+
+  /** Number of live rules. */
+  get size(): number {
+    return this.#slots.size;
+  }
+
+  get(name: string): S | undefined {
+    const slot = this.#slots.get(name);
+    return slot === undefined ? undefined : this.#styles[slot];
+  }
+
+  /** Add `name` at the end, or replace its style in place (keeping its position). */
+  set(name: string, style: S): void {
+    const slot = this.#slots.get(name);
+    if (slot === undefined) {
+      this.#slots.set(name, this.#names.length);
+      this.#names.push(name);
+      this.#styles.push(style);
+    } else {
+      if (this.#byProperty) this.#unlink(this.#styles[slot]!, name);
+      this.#styles[slot] = style;
+    }
+    if (this.#byProperty) this.#link(style, name);
+  }
+
+  /** Remove `name`; false when there was no such rule. */
+  delete(name: string): boolean {
+    const slot = this.#slots.get(name);
+    if (slot === undefined) return false;
+    if (this.#byProperty) this.#unlink(this.#styles[slot]!, name);
+    this.#styles[slot] = undefined;
+    this.#slots.delete(name);
+    if (this.#byProperty) this.#reindex(name);
+    if (++this.#dead > MIN_TOMBSTONES && this.#dead > this.#slots.size) this.#compact();
+    return true;
+  }
+
+  /** Re-read the properties of every rule that uses `style` after it changed. */
+  changed(style: S): void {
+    const names = this.#byProperty ? this.#namesOf.get(style) : undefined;
+    if (names) for (const name of names) this.#reindex(name);
+  }
+
+  /** Re-read the properties of rule `name`; a removed rule is only dropped. */
+  #reindex(name: string): void {
+    const index = this.#byProperty;
+    if (!index) return;
+    const previous = this.#indexedAs.get(name);
+    if (previous) {
+      for (const prop of previous) {
+        const names = index.get(prop);
+        if (!names) continue;
+        names.delete(name);
+        if (names.size === 0) index.delete(prop);
+      }
+      this.#indexedAs.delete(name);
+    }
+    const style = this.get(name);
+    if (style === undefined) return;
+    const properties = this.#propertiesOf(style);
+    for (const prop of properties) {
+      let names = index.get(prop);
+      if (!names) index.set(prop, (names = new Set()));
+      names.add(name);
+    }
+    this.#indexedAs.set(name, properties);
+  }
+
+  /** Names of the rules that set `property`, in stylesheet order. */
+  withProperty(property: string): string[] {
+    if (!this.#byProperty) {
+      this.#byProperty = new Map();
+      this.forEach((name, style) => this.#link(style, name));
+    }
+    const names = this.#byProperty.get(property);
+    if (!names) return [];
+    const slots = this.#slots;
+    return [...names].sort((a, b) => slots.get(a)! - slots.get(b)!);
+  }
+
+  /** Calls `fn` for every live rule in stylesheet order; cheaper than iterating. */
+  forEach(fn: (name: string, style: S) => void): void {
+    const names = this.#names;
+    const styles = this.#styles;
+    for (let i = 0; i < names.length; i++) {
+      const style = styles[i];
+      if (style !== undefined) fn(names[i], style);
+    }
+  }
+
+  /** Live rules in stylesheet order. */
+  *[Symbol.iterator](): IterableIterator<[string, S]> {
+    const names = this.#names;
+    const styles = this.#styles;
+    for (let i = 0; i < names.length; i++) {
+      const style = styles[i];
+      if (style !== undefined) yield [names[i], style];
+    }
+  }
+
+  #link(style: S, name: string): void {
+    let names = this.#namesOf.get(style);
+    if (!names) this.#namesOf.set(style, (names = new Set()));
+    names.add(name);
+    this.#reindex(name);
+  }
+
+  #unlink(style: S, name: string): void {
+    const names = this.#namesOf.get(style);
+    if (!names) return;
+    names.delete(name);
+    if (names.size === 0) this.#namesOf.delete(style);
+  }
+
+  #compact(): void {
+    const names: string[] = [];
+    const styles: S[] = [];
+    for (let i = 0; i < this.#names.length; i++) {
+      const style = this.#styles[i];
+      if (style === undefined) continue;
+      this.#slots.set(this.#names[i], names.length);
+      names.push(this.#names[i]);
+      styles.push(style);
+    }
+    this.#names = names;
+    this.#styles = styles;
+    this.#dead = 0;
+  }
+}
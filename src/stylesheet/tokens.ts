@@ -0,0 +1,228 @@
+/**
+ * # TokenGraph
+ * Design tokens behind StyleSheet#defineToken.
+ *
+ * A token is a string (which may itself contain `var(--other)`), a Color,
+ * or a function deriving a value from other tokens. Resolved values are
+ * cached. Every token records the tokens it read while resolving, and every
+ * consumer (StyleSheet passes its InlineStyles) records the tokens it
+ * referenced. Redefining a token therefore reaches exactly the tokens and
+ * consumers that depend on it, directly or through other tokens.
+ */
+
+import Color from "../color/index.js";
+
+export type TokenValue = string | Color;
+
+/** Reads another token from inside a derived token; records the dependency. */
+export type TokenReader = (name: string) => TokenValue | undefined;
+
+export type TokenDefinition = TokenValue | ((token: TokenReader) => TokenValue);
+
+/** `--brand` and `brand` name the same token. */
+export function tokenName(name: string): string {
+  return name.startsWith("--") ? name.slice(2) : name;
+}
+
+function isNameCode(code: number): boolean {
+  return (
+    (code >= 48 && code <= 57) ||
+    (code >= 65 && code <= 90) ||
+    (code >= 97 && code <= 122) ||
+    code === 45 ||
+    code === 95 ||
+    code >= 0x80
+  );
+}
+
+/**
+ * Replace every `var(--name)` / `var(--name, fallback)` in `text` whose
+ * token `lookup` knows. References `lookup` does not know are kept as they
+ * are, so the browser can still resolve them; defined tokens inside their
+ * fallbacks are replaced. Every referenced name is reported to `seen`.
+ */
+export function substituteTokens(
+  text: string,
+  lookup: (name: string) => string | undefined,
+  seen: (name: string) => void,
+): string {
+  let at = text.indexOf("var(");
+  if (at === -1) return text;
+  let out = "";
+  let copied = 0;
+  while (at !== -1) {
+    let i = at + 4;
+    while (i < text.length && text.charCodeAt(i) <= 32) i++;
+    if (!text.startsWith("--", i)) {
+      at = text.indexOf("var(", i);
+      continue;
+    }
+    const nameStart = i + 2;
+    let nameEnd = nameStart;
+    while (nameEnd < text.length && isNameCode(text.charCodeAt(nameEnd))) nameEnd++;
+    // Closing parenthesis of this var(), skipping nested ones in the fallback.
+    let end = nameEnd;
+    for (let depth = 0; end < text.length; end++) {
+      const c = text.charCodeAt(end);
+      if (c === 40) depth++;
+      else if (c === 41 && depth-- === 0) break;
+    }
+    const name = text.slice(nameStart, nameEnd);
+    seen(name);
+    const value = end < text.length ? lookup(name) : undefined;
+    if (value === undefined) {
+      at = text.indexOf("var(", nameEnd);
+      continue;
+    }
+    out += text.slice(copied, at) + value;
+    copied = end + 1;
+    at = text.indexOf("var(", copied);
+  }
+  return copied === 0 ? text : out + text.slice(copied);
+}
+
+export class TokenGraph<C> {
+  #definitions = new Map<string, TokenDefinition>();
+  /** Resolved values; a missing entry means not resolved yet. */
+  #values = new Map<string, TokenValue | undefined>();
+  /** token -> tokens it read while resolving, and the reverse edges. */
+  #reads = new Map<string, Set<string>>();
+  #readBy = new Map<string, Set<string>>();
+  /** token -> consumers that reference it, and the reverse edges. */
+  #consumers = new Map<string, Set<C>>();
+  #consumes = new Map<C, Set<string>>();
+  #resolving = new Set<string>();
+  #onError: (name: string, reason: string) => void;
+
+  /**
+   * @param onError Called when a token depends on itself or its function
+   * throws; the token then resolves as undefined.
+   */
+  constructor(onError: (name: string, reason: string) => void) {
+    this.#onError = onError;
+  }
+
+  get size(): number {
+    return this.#definitions.size;
+  }
+
+  /** Define or replace a token. Returns the consumers whose output changes. */
+  define(name: string, definition: TokenDefinition): Set<C> {
+    this.#definitions.set(name, definition);
+    return this.#invalidate(name);
+  }
+
+  /** Remove a token. Returns the consumers whose output changes. */
+  delete(name: string): Set<C> {
+    if (!this.#definitions.delete(name)) return new Set();
+    return this.#invalidate(name);
+  }
+
+  /** Resolved value of `name`: a Color or CSS text with tokens substituted. */
+  value(name: string): TokenValue | undefined {
+    if (this.#values.has(name)) return this.#values.get(name);
+    const definition = this.#definitions.get(name);
+    if (definition === undefined) return undefined;
+    if (this.#resolving.has(name)) {
+      this.#onError(name, "it depends on itself");
+      return undefined;
+    }
+
+    this.#resolving.add(name);
+    let value: TokenValue | undefined;
+    try {
+      let raw: TokenValue | undefined = definition as TokenValue;
+      if (typeof definition === "function") {
+        try {
+          raw = definition((other) => this.#read(name, tokenName(other)));
+        } catch (e) {
+          this.#onError(name, `its function threw: ${(e as Error)?.message ?? e}`);
+          raw = undefined;
+        }
+      }
+      value = typeof raw === "string" ? this.substitute(raw, (other) => this.#link(name, other)) : raw;
+    } finally {
+      this.#resolving.delete(name);
+    }
+    this.#values.set(name, value);
+    return value;
+  }
+
+  /** CSS text of `name`; Colors use Color#css(). */
+  text(name: string): string | undefined {
+    const value = this.value(name);
+    return value instanceof Color ? value.css() : value;
+  }
+
+  /** substituteTokens() against this graph. */
+  substitute(text: string, seen: (name: string) => void): string {
+    return substituteTokens(text, (name) => this.text(name), seen);
+  }
+
+  /** Record that `consumer` references `names` (in addition to earlier ones). */
+  track(consumer: C, names: string[]): void {
+    let consumed = this.#consumes.get(consumer);
+    if (!consumed) this.#consumes.set(consumer, (consumed = new Set()));
+    for (const name of names) {
+      let consumers = this.#consumers.get(name);
+      if (!consumers) this.#consumers.set(name, (consumers = new Set()));
+      consumers.add(consumer);
+      consumed.add(name);
+    }
+  }
+
+  /** Forget everything `consumer` referenced. */
+  untrack(consumer: C): void {
+    const names = this.#consumes.get(consumer);
+    if (!names) return;
+    for (const name of names) {
+      const consumers = this.#consumers.get(name);
+      consumers?.delete(consumer);
+      if (consumers?.size === 0) this.#consumers.delete(name);
+    }
+    this.#consumes.delete(consumer);
+  }
+
+  /** Defined token names with their CSS text, in definition order. */
+  *entries(): IterableIterator<[string, string | undefined]> {
+    for (const name of this.#definitions.keys()) yield [name, this.text(name)];
+  }
+
+  #read(reader: string, name: string): TokenValue | undefined {
+    this.#link(reader, name);
+    return this.value(name);
+  }
+
+  #link(reader: string, name: string): void {
+    let reads = this.#reads.get(reader);
+    if (!reads) this.#reads.set(reader, (reads = new Set()));
+    reads.add(name);
+    let readBy = this.#readBy.get(name);
+    if (!readBy) this.#readBy.set(name, (readBy = new Set()));
+    readBy.add(reader);
+  }
+
+  /** Drop the cached values of `name` and everything that read it; collect their consumers. */
+  #invalidate(name: string): Set<C> {
+    const affected = new Set<C>();
+    const pending = [name];
+    const visited = new Set<string>();
+    while (pending.length > 0) {
+      const token = pending.pop()!;
+      if (visited.has(token)) continue;
+      visited.add(token);
+      this.#values.delete(token);
+      // Edges are recorded again the next time the token resolves.
+      const reads = this.#reads.get(token);
+      if (reads) {
+        for (const other of reads) this.#readBy.get(other)?.delete(token);
+        this.#reads.delete(token);
+      }
+      const consumers = this.#consumers.get(token);
+      if (consumers) for (const consumer of consumers) affected.add(consumer);
+      const readBy = this.#readBy.get(token);
+      if (readBy) for (const reader of readBy) pending.push(reader);
+    }
+    return affected;
+  }
+}
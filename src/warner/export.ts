@@ -0,0 +1,212 @@
+/**
+ * Machine-readable warning export used by `Warner#exportTo`.
+ *
+ * **ndjson**: one self-contained JSON object per line.
+ *
+ * **binary**: a "BWRN" magic and a version byte, then length-prefixed
+ * records. All integers are little-endian. Every record is
+ * `u32 length, u8 kind, body`, where `length` counts the kind byte and the body:
+ * - kind 1, string table entry: `u8 table, u32 id, str value`
+ * - kind 2, warning: `f64 time, u32 count, u32 package, u32 tag, u32 source,
+ *   u32 scope, str message, str hint, str otherMessage, str documentation`
+ *
+ * `str` is `u32 byteLength` followed by UTF-8 bytes, and `0xffffffff` means
+ * absent. Package/tag/source/scope are ids into the tables (`0xffffffff`
+ * for none); an entry is written once, right before its first use.
+ *
+ * Backpressure: once `target.write()` returns false, whole records are
+ * queued and written out in order on "drain", so nothing is lost. With
+ * `maxPendingBytes`, warnings arriving while the queue is past that size are
+ * dropped instead (and counted by the warner); a dropped warning writes
+ * nothing, so the output stays parseable.
+ */
+
+import type { Warning } from "./index.js";
+
+export type WarningExportFormat = "ndjson" | "binary";
+
+/**
+ * Anything with a `write` method, e.g. a Node `Writable` or `process.stdout`.
+ * Without `once`, a `false` from `write` cannot be waited on and is ignored.
+ */
+export interface WarningExportTarget {
+  write(chunk: string | Uint8Array): unknown;
+  once?(event: "drain", listener: () => void): unknown;
+}
+
+export interface WarningExportOptions {
+  /** Output layout. Default: "ndjson" */
+  format?: WarningExportFormat;
+  /** Also write the warnings already kept by the warner. Default: true */
+  includeExisting?: boolean;
+  /**
+   * Queued bytes (UTF-16 code units for ndjson) past which warnings are
+   * dropped while the target waits for "drain". Default: Infinity, i.e.
+   * queue everything.
+   */
+  maxPendingBytes?: number;
+}
+
+export const BINARY_MAGIC = "BWRN";
+export const BINARY_VERSION = 1;
+
+const KIND_STRING = 1;
+const KIND_WARNING = 2;
+
+const TABLE_PACKAGE = 0;
+const TABLE_TAG = 1;
+const TABLE_SOURCE = 2;
+const TABLE_SCOPE = 3;
+
+const NONE = 0xffffffff;
+const encoder = new TextEncoder();
+
+export class WarningExporter {
+  #target: WarningExportTarget;
+  #format: WarningExportFormat;
+  #tables: Map<string, number>[] = [new Map(), new Map(), new Map(), new Map()];
+  #headerWritten = false;
+  #maxPending: number;
+  /** Chunks waiting for "drain"; null while the target accepts writes. */
+  #pending: (string | Uint8Array)[] | null = null;
+  #pendingSize = 0;
+
+  constructor(target: WarningExportTarget, format: WarningExportFormat, maxPendingBytes = Infinity) {
+    this.#target = target;
+    this.#format = format;
+    this.#maxPending = maxPendingBytes;
+  }
+
+  /**
+   * Write one warning seen `count` times so far, or queue it while the
+   * target waits for "drain". Returns false, writing nothing, when the queue
+   * is past maxPendingBytes.
+   */
+  write(w: Warning, count: number, packageName: string, time: number): boolean {
+    if (this.#pending !== null && this.#pendingSize >= this.#maxPending) return false;
+    this.#record(w, count, packageName, time);
+    return true;
+  }
+
+  #put(chunk: string | Uint8Array) {
+    if (this.#pending !== null) {
+      this.#pending.push(chunk);
+      this.#pendingSize += chunk.length;
+    } else if (this.#target.write(chunk) === false && typeof this.#target.once === "function") {
+      this.#pending = [];
+      this.#target.once("drain", this.#flush);
+    }
+  }
+
+  /** Write whatever is still queued now, backpressure or not; used when the export stops. */
+  close() {
+    const pending = this.#pending;
+    this.#pending = null;
+    this.#pendingSize = 0;
+    if (pending) for (const chunk of pending) this.#target.write(chunk);
+  }
+
+  /** Write queued chunks in order until the queue is empty or the target is full again. */
+  #flush = () => {
+    const pending = this.#pending;
+    if (pending === null) return;
+    let i = 0;
+    while (i < pending.length) {
+      const chunk = pending[i++];
+      this.#pendingSize -= chunk.length;
+      if (this.#target.write(chunk) === false && i < pending.length) {
+        this.#pending = pending.slice(i);
+        this.#target.once!("drain", this.#flush);
+        return;
+      }
+    }
+    this.#pending = null;
+    this.#pendingSize = 0;
+  };
+
+  #record(w: Warning, count: number, packageName: string, time: number) {
+    if (this.#format === "ndjson") {
+      this.#put(
+        JSON.stringify({
+          time,
+          count,
+          package: packageName || undefined,
+          tag: w.tag,
+          source: w.source,
+          scope: w.scope,
+          message: w.message,
+          hint: w.hint,
+          otherMessage: w.otherMessage,
+          documentation: w.documentation,
+        }) + "\n",
+      );
+      return;
+    }
+
+    if (!this.#headerWritten) {
+      this.#headerWritten = true;
+      const header = new Uint8Array(5);
+      header.set(encoder.encode(BINARY_MAGIC));
+      header[4] = BINARY_VERSION;
+      this.#put(header);
+    }
+    const pkg = this.#intern(TABLE_PACKAGE, packageName || undefined);
+    const tag = this.#intern(TABLE_TAG, w.tag);
+    const source = this.#intern(TABLE_SOURCE, w.source);
+    const scope = this.#intern(TABLE_SCOPE, w.scope);
+    const strings = [w.message, w.hint, w.otherMessage, w.documentation].map((s) =>
+      s === undefined ? undefined : encoder.encode(s),
+    );
+
+    let size = 1 + 8 + 4 * 5;
+    for (const bytes of strings) size += 4 + (bytes?.length ?? 0);
+    const { out, view } = frame(size, KIND_WARNING);
+    let o = 5;
+    view.setFloat64(o, time, true);
+    view.setUint32((o += 8), count, true);
+    view.setUint32((o += 4), pkg, true);
+    view.setUint32((o += 4), tag, true);
+    view.setUint32((o += 4), source, true);
+    view.setUint32((o += 4), scope, true);
+    o += 4;
+    for (const bytes of strings) o = putString(out, view, o, bytes);
+    this.#put(out);
+  }
+
+  /** Id of `value` in `table`, writing the table entry first if it is new. */
+  #intern(table: number, value: string | undefined): number {
+    if (value === undefined) return NONE;
+    const ids = this.#tables[table];
+    let id = ids.get(value);
+    if (id !== undefined) return id;
+    id = ids.size;
+    ids.set(value, id);
+
+    const bytes = encoder.encode(value);
+    const { out, view } = frame(1 + 1 + 4 + 4 + bytes.length, KIND_STRING);
+    out[5] = table;
+    view.setUint32(6, id, true);
+    putString(out, view, 10, bytes);
+    this.#put(out);
+    return id;
+  }
+}
+
+/** Allocate a record of `size` body bytes with its length prefix and kind. */
+function frame(size: number, kind: number) {
+  const out = new Uint8Array(4 + size);
+  const view = new DataView(out.buffer);
+  view.setUint32(0, size, true);
+  out[4] = kind;
+  return { out, view };
+}
+
+function putString(out: Uint8Array, view: DataView, offset: number, bytes: Uint8Array | undefined) {
+  if (bytes === undefined) {
+    view.setUint32(offset, NONE, true);
+    return offset + 4;
+  }
+  view.setUint32(offset, bytes.length, true);
+  out.set(bytes, offset + 4);
+  return offset + 4 + bytes.length;
+}
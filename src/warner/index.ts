@@ -3,10 +3,12 @@
  */
 
 import { loadNativeAddon } from "../native/load.js";
+import type { OutputSink } from "./sink.js";
+import { WarningExporter, type WarningExportOptions, type WarningExportTarget } from "./export.js";
 
 const IS_BROWSER = typeof window !== "undefined" && typeof window?.console !== "undefined";
 const IS_NODE = typeof process !== "undefined" && !!process.stdout;
-export const native = loadNativeAddon(import.meta.url, "warner");
+export const native = loadNativeAddon("warner");
 
 const NODE_STYLES = {
     label: "\x1b[35m",  
@@ -63,21 +65,57 @@ export interface Warning {
     /**
      * documentation
      */
-    documentation?:string
+    documentation?:string,
+    /**
+     * Function or class the warning comes from, shown as "[scope]".
+     * Formatting is deferred until the warning is printed.
+     */
+    scope?: string,
+    /**
+     * Extra line shown after the hint, e.g. the fallback that was used
+     */
+    otherMessage?: string
 }
 
+/**
+ * What Warner keeps once `maxWarnings` is reached
+ *
+ * **keep-first**: the first `maxWarnings` warnings, later ones are dropped
+ *
+ * **keep-last**: the latest `maxWarnings` warnings, the oldest are overwritten
+ */
+export type WarningOverflow = "keep-first" | "keep-last";
+
 export interface WarnerOptions {
   /** Debug level */
   level?: WarningLevel;
 
-  /** Max warnings */
+  /** Max warnings kept in memory */
   maxWarnings?: number;
 
+  /** Which warnings to keep once maxWarnings is reached */
+  overflow?: WarningOverflow;
+
+  /** Fold repeats of the same message/tag/source into one counted record */
+  dedupe?: boolean;
+
+  /**
+   * Fraction (0..1] of repeated warnings passed to onWarn; the first
+   * occurrence is always passed. Per message/tag/source when dedupe is on.
+   */
+  sampleRate?: number;
+
+  /**
+   * Buffered sink for Node output instead of synchronous console calls,
+   * e.g. `getOutputSink("stderr")`. Flushed by flush()/finalize().
+   */
+  output?: OutputSink;
+
   /** Custom output handler */
   onWarn?: (warning: Warning) => unknown;
 
   /** Custom summary handler */
-  onSummary?: (count: number, warnings: Warning[]) => unknown;
+  onSummary?: (count: number, warnings: readonly Warning[]) => unknown;
 
   /**Package name */
   packageName?: string;
@@ -85,6 +123,24 @@ export interface WarnerOptions {
   /** Protection level */
   protectionLevel?: ProtectionLevel;
 }
+/**
+ * How often a deduplicated warning was seen
+ */
+export interface WarningOccurrence {
+  count: number;
+  /** Date.now() of the first occurrence */
+  firstSeen: number;
+  /** Date.now() of the latest occurrence */
+  lastSeen: number;
+}
+
+/** dedupe: most warnings that were not kept whose repeats are still counted. */
+const UNKEPT_KEYS_LIMIT = 1024;
+
+function dedupeKey(w: Warning): string {
+  return `${w.tag ?? ""}\u0000${w.source ?? ""}\u0000${w.scope ?? ""}\u0000${w.message}`;
+}
+
 function isWarning(value: unknown): value is Warning {
   if (!value || typeof value !== "object") return false;
   const p = value as Partial<Warning>;
@@ -94,32 +150,94 @@ function isWarning(value: unknown): value is Warning {
     (typeof p.hint === "string" || p.hint === undefined) &&
     (typeof p.instantlyWarn === "boolean" || p.instantlyWarn === undefined) &&
     (typeof p.tag === "string" || p.tag === undefined) &&
-    (typeof p.documentation === "string" || p.documentation === undefined)
+    (typeof p.documentation === "string" || p.documentation === undefined) &&
+    (typeof p.scope === "string" || p.scope === undefined) &&
+    (typeof p.otherMessage === "string" || p.otherMessage === undefined)
   );
 }
+/** Rotate `items` left by `k` in place (three reversals, no allocation). */
+function rotateLeft<T>(items: T[], k: number): void {
+  const reverse = (from: number, to: number) => {
+    for (to--; from < to; from++, to--) {
+      const t = items[from];
+      items[from] = items[to];
+      items[to] = t;
+    }
+  };
+  reverse(0, k);
+  reverse(k, items.length);
+  reverse(0, items.length);
+}
+
 /**
  * A Warner instance
  */
 export class Warner {
+    /** Ring buffer of at most #capacity warnings, oldest at #head. */
     #warnings: Warning[] = [];
+    #head = 0;
+    #capacity = 0;
+    /** Warnings received since the last clear(), kept or not. */
+    #total = 0;
+    /** dedupe: occurrences of every kept warning, by dedupeKey. */
+    #occurrences = new Map<string, WarningOccurrence>();
+    /**
+     * dedupe: occurrences of warnings that were not kept (keep-first with a
+     * full buffer, or maxWarnings 0), so their repeats are still folded and
+     * sampled. Bounded; the oldest keys are forgotten first.
+     */
+    #unkept = new Map<string, WarningOccurrence>();
+    /** dedupe: repeats folded into a kept record. */
+    #folded = 0;
+    /** sampleRate without dedupe: occurrences seen by the sampler. */
+    #sampled = 0;
+    /** Warnings an exporter skipped while its target was waiting for "drain". */
+    #unexported = 0;
     #options: WarnerOptions = {};
     #protectionLevel: ProtectionLevel = "boundary";
+    /** Whether onWarn/onSummary were given, i.e. someone observes silent warnings. */
+    #observed = false;
+    #exporters: WarningExporter[] = [];
 
     constructor(options: WarnerOptions = {}) {
+        this.#observed = Boolean(options.onWarn || options.onSummary);
         options.level = options.level ?? "summary";
         options.maxWarnings = Number(options.maxWarnings ?? 20);
         options.onWarn = options.onWarn ?? (() => {});
         options.onSummary = options.onSummary ?? (() => {});
         options.packageName = options.packageName ?? "";
         options.protectionLevel = options.protectionLevel ?? "boundary";
+        options.overflow = options.overflow === "keep-last" ? "keep-last" : "keep-first";
+        options.dedupe = Boolean(options.dedupe);
+        const rate = Number(options.sampleRate ?? 1);
+        options.sampleRate = rate > 0 ? Math.min(rate, 1) : 0;
         this.#protectionLevel = options.protectionLevel;
         this.#options = options;
+        this.#capacity = options.maxWarnings > 0 ? Math.ceil(options.maxWarnings) : 0;
     }
 
-    get warnings(): Warning[] {
+    /**
+     * Kept warnings, oldest first.
+     * This is a read-only view of the internal buffer, not a copy; it is
+     * only valid until the next warn() or clear().
+     */
+    get warnings(): readonly Warning[] {
+        if (this.#head !== 0) {
+            rotateLeft(this.#warnings, this.#head);
+            this.#head = 0;
+        }
         return this.#warnings;
     }
 
+    /**
+     * False when the level is "silent" and no onWarn/onSummary handler is
+     * set, so nothing would ever see a warning. Check it before building
+     * an expensive payload.
+     */
+    get enabled(): boolean {
+        return this.#options.level !== "silent" || this.#observed || this.#exporters.length > 0;
+    }
+
     setLevel(level: WarningLevel) {
         if (["silent", "summary", "full"].includes(level)) this.#options.level = level;
     }
@@ -141,26 +259,162 @@ export class Warner {
 
     clear() {
         this.#warnings = [];
+        this.#head = 0;
+        this.#total = 0;
+        this.#occurrences.clear();
+        this.#unkept.clear();
+        this.#folded = 0;
+        this.#sampled = 0;
+        this.#unexported = 0;
     }
 
+    /** Number of warnings kept in memory. */
     count(): number {
         return this.#warnings.length;
     }
 
+    /** Number of warnings received since the last clear(), including dropped ones. */
+    total(): number {
+        return this.#total;
+    }
+
+    /** Number of warnings that were not kept because of maxWarnings. */
+    dropped(): number {
+        return this.#total - this.#warnings.length - this.#folded;
+    }
+
+    /** Number of warnings exportTo() targets dropped past their maxPendingBytes. */
+    unexported(): number {
+        return this.#unexported;
+    }
+
+    /**
+     * With `dedupe`, how often a warning (or one with the same
+     * message/tag/source) was seen, kept or not. Undefined otherwise.
+     */
+    occurrences(warning: Warning): WarningOccurrence | undefined {
+        return isWarning(warning) ? this.#occurrence(dedupeKey(warning)) : undefined;
+    }
+
+    #occurrence(key: string): WarningOccurrence | undefined {
+        return this.#occurrences.get(key) ?? this.#unkept.get(key);
+    }
+
     warn(warning: Warning) {
         if (!isWarning(warning)) return;
-        if (this.#options.maxWarnings && this.#warnings.length < this.#options.maxWarnings) {
+        this.#total++;
+
+        let seen: number;
+        if (this.#options.dedupe) {
+            const key = dedupeKey(warning);
+            const now = Date.now();
+            const existing = this.#occurrences.get(key);
+            if (existing) {
+                this.#folded++;
+                existing.lastSeen = now;
+                seen = ++existing.count;
+                this.#sample(warning, seen);
+                return;
+            }
+            // A repeat of a warning that was not kept is still not kept (so it
+            // counts as dropped), but it is deduplicated and sampled all the same.
+            const unkept = this.#unkept.get(key);
+            if (unkept) {
+                unkept.lastSeen = now;
+                seen = ++unkept.count;
+                this.#sample(warning, seen);
+                return;
+            }
+            const record = { count: 1, firstSeen: now, lastSeen: now };
+            if (this.#keep(warning)) {
+                this.#occurrences.set(key, record);
+            } else {
+                if (this.#unkept.size >= UNKEPT_KEYS_LIMIT) this.#unkept.delete(this.#unkept.keys().next().value!);
+                this.#unkept.set(key, record);
+            }
+            seen = 1;
+        } else {
+            this.#keep(warning);
+            seen = ++this.#sampled;
+        }
+        this.#sample(warning, seen);
+
+        if (warning.instantlyWarn) {
+            this.#print(warning);
+            return;
+        }
+    }
+
+    /** Store a new warning; false when it is dropped. */
+    #keep(warning: Warning): boolean {
+        if (this.#warnings.length < this.#capacity) {
             this.#warnings.push(warning);
+            return true;
+        }
+        if (this.#capacity === 0 || this.#options.overflow !== "keep-last") return false;
+        if (this.#options.dedupe) {
+            const evicted = dedupeKey(this.#warnings[this.#head]);
+            this.#folded -= this.#occurrences.get(evicted)!.count - 1;
+            this.#occurrences.delete(evicted);
         }
+        this.#warnings[this.#head] = warning;
+        this.#head = this.#head + 1 === this.#capacity ? 0 : this.#head + 1;
+        return true;
+    }
+
+    /** Forward the n-th occurrence to onWarn and exporters if it falls on the sampling rate. */
+    #sample(warning: Warning, n: number) {
+        const rate = this.#options.sampleRate!;
+        if (n !== 1 && Math.floor(n * rate) === Math.floor((n - 1) * rate)) return;
         try {
             this.#options.onWarn?.(warning);
         } catch (e) {
         }
+        if (this.#exporters.length === 0) return;
+        const count = this.#options.dedupe ? n : 1;
+        const time = Date.now();
+        for (const exporter of this.#exporters) {
+            if (!exporter.write(warning, count, this.#options.packageName!, time)) this.#unexported++;
+        }
+    }
 
-        if (warning.instantlyWarn) {
-            this.#print(warning);
-            return;
+    /**
+     * Stream warnings to `target` as they arrive (subject to sampleRate),
+     * as NDJSON lines or length-prefixed binary records without ANSI codes.
+     * While the target applies backpressure (write() returned false, no
+     * "drain" yet) records are queued and written on "drain"; with
+     * `maxPendingBytes` set, warnings past that queue size are dropped and
+     * counted by `unexported()`. Returns a function that stops the export and
+     * writes out anything still queued; call it before ending the target.
+     * @example
+     * const out = fs.createWriteStream("warnings.ndjson");
+     * const stop = warner.exportTo(out);
+     * // ...
+     * stop();
+     * out.end();
+     */
+    exportTo(target: WarningExportTarget, options: WarningExportOptions = {}): () => void {
+        if (!target || typeof target.write !== "function") {
+            throw new TypeError("Warner.exportTo: the target must have a write() method.");
+        }
+        const exporter = new WarningExporter(
+            target,
+            options.format === "binary" ? "binary" : "ndjson",
+            options.maxPendingBytes,
+        );
+        if (options.includeExisting ?? true) {
+            for (const w of this.warnings) {
+                const seen = this.#options.dedupe ? this.#occurrences.get(dedupeKey(w)) : undefined;
+                if (!exporter.write(w, seen?.count ?? 1, this.#options.packageName!, seen?.lastSeen ?? Date.now())) {
+                    this.#unexported++;
+                }
+            }
         }
+        this.#exporters.push(exporter);
+        return () => {
+            this.#exporters = this.#exporters.filter((e) => e !== exporter);
+            exporter.close();
+        };
     }
 
   /**
@@ -174,7 +428,8 @@ export class Warner {
     const lines: any[] = [];
     const label = this.#options.packageName ? `${this.#options.packageName}: ` : "";
     const tagOrSource = w.tag ? `[${w.tag}] ` : w.source ? `[${w.source}] ` : "";
-    const header = `${tagOrSource}${label}${w.message}`;
+    const scope = w.scope ? `[${w.scope}] ` : "";
+    const header = `${tagOrSource}${scope}${label}${w.message}${this.#repeats(w)}`;
     const cssHeader = "background:#222;color:#fff;padding:2px 6px;border-radius:4px;font-weight:700;";
     lines.push(header, cssHeader);
     if (w.hint) {
@@ -183,32 +438,47 @@ export class Warner {
     if (w.documentation) {
       lines.push(`\nDocumentation: ${w.documentation}`, "color:#0af;font-weight:600;");
     }
+    if (w.otherMessage) {
+      lines.push(`\n${w.otherMessage}`, "");
+    }
     return lines;
   }
 
+  /** " (xN)" for a deduplicated warning seen more than once. */
+  #repeats(w: Warning) {
+    if (!this.#options.dedupe) return "";
+    const count = this.#occurrence(dedupeKey(w))?.count ?? 1;
+    return count > 1 ? ` (x${count})` : "";
+  }
+
+  #summaryText() {
+    const notes: string[] = [];
+    if (this.#options.dedupe) notes.push(`${this.#occurrences.size + this.#unkept.size} unique`);
+    const dropped = this.dropped();
+    if (dropped > 0) notes.push(`${dropped} not kept`);
+    if (this.#unexported > 0) notes.push(`${this.#unexported} not exported`);
+    return `${this.#total} warnings collected${notes.length ? ` (${notes.join(", ")})` : ""}`;
+  }
+
   #formatSummaryForBrowser() {
-    const count = this.#warnings.length;
-    const max = this.#options.maxWarnings;
-    const displayCount = max ? (count > max ? `${max}+` :  JSON.stringify(count)) :  JSON.stringify(count);
-    const msg = `${displayCount} warnings collected`;
+    const msg = this.#summaryText();
     const css = "background:#f9a825;color:#000;padding:4px 8px;border-radius:4px;font-weight:700;";
     return [msg, css];
   }
 
   #formatSummaryForNode() {
-    const count = this.#warnings.length;
-    const max = this.#options.maxWarnings;
-    const displayCount = max ? (count > max ? `${max}+` :  JSON.stringify(count)) :  JSON.stringify(count);
-    return `${NODE_STYLES.bold}${NODE_STYLES.label}[SUMMARY]${NODE_STYLES.reset} ${displayCount} warnings collected${NODE_STYLES.reset}`;
+    return `${NODE_STYLES.bold}${NODE_STYLES.label}[SUMMARY]${NODE_STYLES.reset} ${this.#summaryText()}${NODE_STYLES.reset}`;
   }
 
   #formatForNode(w: Warning) {
     const parts: string[] = [];
     const t = w.tag ? `${NODE_STYLES.tag}[${w.tag}]${NODE_STYLES.reset} ` : w.source ? `${NODE_STYLES.tag}[${w.source}]${NODE_STYLES.reset} ` : "";
     const pkg = this.#options.packageName ? `${NODE_STYLES.label}${this.#options.packageName}${NODE_STYLES.reset}: ` : "";
-    parts.push(`${t}${pkg}${NODE_STYLES.bold}${w.message}${NODE_STYLES.reset}`);
+    const scope = w.scope ? `${NODE_STYLES.tag}[${w.scope}]${NODE_STYLES.reset} ` : "";
+    parts.push(`${t}${scope}${pkg}${NODE_STYLES.bold}${w.message}${NODE_STYLES.reset}${this.#repeats(w)}`);
     if (w.hint) parts.push(`${NODE_STYLES.hint}Hint: ${w.hint}${NODE_STYLES.reset}`);
     if (w.documentation) parts.push(`Documentation: ${w.documentation}`);
+    if (w.otherMessage) parts.push(w.otherMessage);
     return parts.join("\n");
   }
 
@@ -228,30 +498,35 @@ export class Warner {
         }
 
         if (IS_NODE) {
-            console.warn(this.#formatForNode(w));
+            if (this.#options.output) this.#options.output.write(this.#formatForNode(w));
+            else console.warn(this.#formatForNode(w));
             return;
         }
 
-        console.warn(`${this.#options.packageName ? this.#options.packageName + ': ' : ''}${w.message}`);
+        const scope = w.scope ? `[${w.scope}] ` : "";
+        console.warn(`${scope}${this.#options.packageName ? this.#options.packageName + ': ' : ''}${w.message}${this.#repeats(w)}`);
     }
 
     flush() {
         if (this.#options.level === "full") {
-            this.#warnings.forEach((w) => {
+            for (const w of this.warnings) {
                 if (!w.instantlyWarn) this.#print(w);
-            });
+            }
         }
         if (this.#options.level === "summary") {
             try {
-                this.#options.onSummary?.(this.#warnings.length, [...this.#warnings]);
+                this.#options.onSummary?.(this.#total, this.warnings);
             } catch (e) {}
             if (IS_BROWSER) {
                 const [msg, css] = this.#formatSummaryForBrowser();
                 console.log(`%c${msg}`, css);
+            } else if (IS_NODE && this.#options.output) {
+                this.#options.output.write(this.#formatSummaryForNode());
             } else {
                 console.log(this.#formatSummaryForNode());
             }
         }
+        this.#options.output?.flush();
     }
 }
 const getDefaultLevel = (): WarningLevel => {
@@ -262,6 +537,9 @@ const getDefaultLevel = (): WarningLevel => {
   return "summary";
 };
 export default Warner;
+export { OutputSink, getOutputSink } from "./sink.js";
+export type { OutputSinkOptions, OutputStreamName, OutputTarget } from "./sink.js";
+export type { WarningExportFormat, WarningExportOptions, WarningExportTarget } from "./export.js";
 
 export const warner = new Warner({ level: getDefaultLevel() });
 export function createWarner(packageName: string, options?: WarnerOptions | WarningLevel): Warner {
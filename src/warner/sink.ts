@@ -0,0 +1,140 @@
+/**
+ * Buffered output sink shared by Warner and cli-john's Utilities.
+ *
+ * Lines are coalesced into one string and written with a single
+ * `stream.write` when the buffer reaches `highWaterMark`, on the next
+ * `setImmediate`, on `flush()` or at process exit. Outside Node (or when the
+ * stream is missing) every line goes straight to the console. A custom
+ * `target` replaces the stream, e.g. to forward batches from a worker.
+ */
+
+type NodeUtil = typeof import("node:util");
+
+export type OutputStreamName = "stdout" | "stderr";
+
+/** Where a sink writes its batches; anything with a `write(text)` method. */
+export interface OutputTarget {
+  write(text: string): unknown;
+}
+
+export interface OutputSinkOptions {
+  /** Target stream. Default: "stdout" */
+  stream?: OutputStreamName;
+  /** Write batches here instead of the process stream */
+  target?: OutputTarget;
+  /** Flush as soon as this many UTF-16 code units are buffered. Default: 64 KiB */
+  highWaterMark?: number;
+}
+
+let nodeUtil: NodeUtil | null | undefined;
+
+function getNodeUtil(): NodeUtil | null {
+  if (nodeUtil === undefined) {
+    const getBuiltin = globalThis.process?.getBuiltinModule;
+    nodeUtil = typeof getBuiltin === "function" ? (getBuiltin("node:util") as NodeUtil) : null;
+  }
+  return nodeUtil;
+}
+
+/**
+ * # OutputSink
+ * Buffers formatted lines for one process stream.
+ * @example
+ * const sink = new OutputSink({ stream: "stderr" });
+ * sink.write("first");
+ * sink.write("second"); // both written together on the next tick
+ */
+export class OutputSink {
+  #streamName: OutputStreamName;
+  #target: OutputTarget | undefined;
+  #highWaterMark: number;
+  #chunks: string[] = [];
+  #size = 0;
+  #scheduled = false;
+  #exitHooked = false;
+
+  constructor(options: OutputSinkOptions = {}) {
+    this.#streamName = options.stream === "stderr" ? "stderr" : "stdout";
+    this.#target = typeof options.target?.write === "function" ? options.target : undefined;
+    const hwm = Number(options.highWaterMark ?? 65536);
+    this.#highWaterMark = hwm > 0 ? hwm : 65536;
+  }
+
+  #stream(): OutputTarget | undefined {
+    return this.#target ?? globalThis.process?.[this.#streamName];
+  }
+
+  /** Whether lines are buffered (false outside Node). */
+  get buffered(): boolean {
+    return typeof this.#stream()?.write === "function";
+  }
+
+  /** Number of UTF-16 code units waiting to be written. */
+  get pending(): number {
+    return this.#size;
+  }
+
+  /** Queue one line; a newline is appended. */
+  write(line: string) {
+    if (!this.buffered) {
+      if (this.#streamName === "stderr") console.warn(line);
+      else console.log(line);
+      return;
+    }
+    this.#chunks.push(line, "\n");
+    this.#size += line.length + 1;
+    if (this.#size >= this.#highWaterMark) {
+      this.flush();
+      return;
+    }
+    this.#schedule();
+  }
+
+  /** Queue `console.log`-style arguments, formatted like `console.log` would. */
+  log(...args: unknown[]) {
+    const util = getNodeUtil();
+    if (!util || !this.buffered) {
+      if (this.#streamName === "stderr") console.warn(...args);
+      else console.log(...args);
+      return;
+    }
+    this.write(util.format(...args));
+  }
+
+  /** Write everything buffered so far. */
+  flush() {
+    if (this.#size === 0) return;
+    const text = this.#chunks.length === 2 ? this.#chunks[0] + "\n" : this.#chunks.join("");
+    this.#chunks = [];
+    this.#size = 0;
+    this.#stream()!.write(text);
+  }
+
+  #schedule() {
+    if (!this.#exitHooked) {
+      this.#exitHooked = true;
+      globalThis.process?.once?.("exit", () => this.flush());
+    }
+    if (this.#scheduled) return;
+    this.#scheduled = true;
+    const run = () => {
+      this.#scheduled = false;
+      this.flush();
+    };
+    if (typeof setImmediate === "function") setImmediate(run);
+    else queueMicrotask(run);
+  }
+}
+
+let stdoutSink: OutputSink | undefined;
+let stderrSink: OutputSink | undefined;
+
+/**
+ * Shared sink for a process stream, created on first use.
+ */
+export function getOutputSink(stream: OutputStreamName = "stdout"): OutputSink {
+  if (stream === "stderr") return (stderrSink ??= new OutputSink({ stream }));
+  return (stdoutSink ??= new OutputSink({ stream }));
+}
+
+export default OutputSink;
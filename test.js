@@ -0,0 +1,124 @@
+// Native parity check: the addon must give the same results as the TS path.
+// Run with `pnpm test:native`, or after `pnpm build && pnpm build:native`:
+//   node test.js
+//
+// The same inputs are evaluated twice, each time in a fresh child process:
+// "ts" with BRIKLAB_NATIVE=0 and "native" with the addons loaded (and the
+// jstc routing threshold lowered to 1, as in benchmark.mjs). Exits with code
+// 1 when the addon is missing or any result differs. The warner and
+// cli-john have no native module, so they are not covered.
+
+import { spawnSync } from "node:child_process";
+import { fileURLToPath } from "node:url";
+
+const argv = process.argv.slice(2);
+
+// -------------------------------------------------------------------------------------------------------
+//#region Cases
+async function results() {
+  const { default: Color, ColorBuffer, native: colorNative } = await import("./dist/color/index.js");
+  const { default: JSTC, native: jstcNative } = await import("./dist/jstc/index.js");
+  const { InlineStyle, StyleSheet, native: stylesheetNative } = await import("./dist/stylesheet/index.js");
+
+  const natives = {
+    color: Boolean(colorNative),
+    jstc: Boolean(jstcNative),
+    stylesheet: Boolean(stylesheetNative),
+  };
+
+  const colorInputs = [
+    "#ff8800",
+    "#f80",
+    "#ff880080",
+    "rgb(12, 34, 56)",
+    "rgba(255, 0, 128, 0.5)",
+    "hsl(210, 50%, 40%)",
+    "hsla(20, 100%, 50%, 0.25)",
+    "rebeccapurple",
+    "transparent",
+  ];
+  const out = {};
+  for (const input of colorInputs) {
+    const c = new Color(input);
+    out[`color: ${input}`] = [c.hex(), c.rgba(), c.hsl(), c.css()];
+  }
+  const parsed = new Float32Array(colorInputs.length * 4);
+  Color.parseMany(colorInputs, parsed, "unitrgba");
+  out["color: parseMany"] = Array.from(parsed);
+
+  const palette = ColorBuffer.from(Array.from({ length: 257 }, (_, i) => colorInputs[i % colorInputs.length]));
+  const bytes = (buffer) => Array.from(new Uint8Array(buffer.buffer));
+  out["color: ColorBuffer#lighten"] = bytes(palette.lighten(0.2, new ColorBuffer(palette.length)));
+  out["color: ColorBuffer#mix"] = bytes(palette.mix("#123456", 0.3, new ColorBuffer(palette.length)));
+  out["color: ColorBuffer#contrast"] = Array.from(palette.contrast(new Color("#ff8800")));
+
+  const types = ["number", "string", "boolean|undefined", "string[]", "object"];
+  const args = [[1, "a", true, ["x"], {}], [1, "a", undefined, ["x"], null], ["1", 2, false, [3], {}]];
+  for (const [i, a] of args.entries()) out[`jstc: for(${i}).check`] = JSTC.for(a).check(types);
+  const schema = JSTC.compile(["string", "number", "boolean"]);
+  out["jstc: checkAll"] = JSTC.checkAll([["a", 1, true], ["b", "2", false], [3, 4, true]], schema);
+
+  const style = new InlineStyle({ color: "red", fontWeight: "bold", marginLeft: "4px" });
+  style.addStyleWithInlineCSS("display: flex; padding: 2px 4px; background: url(a;b.png)");
+  out["stylesheet: InlineStyle#generate"] = style.generate();
+  out["stylesheet: InlineStyle#ansi"] = style.ansi;
+  const sheet = new StyleSheet();
+  for (let i = 0; i < 50; i++) {
+    sheet.set(`.rule-${i}`, new InlineStyle({ color: i % 10 ? colorInputs[i % colorInputs.length] : "var(--brand)", padding: `${i}px` }));
+  }
+  sheet.defineToken("brand", new Color("#ff8800"));
+  out["stylesheet: StyleSheet#generate"] = sheet.generate();
+  out["stylesheet: StyleSheet#rulesWith"] = sheet.rulesWith("padding");
+  out["stylesheet: StyleSheet#hash"] = sheet.hash();
+
+  return { natives, out };
+}
+//#endregion
+// -------------------------------------------------------------------------------------------------------
+//#region Orchestration
+function spawnMode(mode) {
+  const env = { ...process.env, BRIKLAB_WARNING_LEVEL: "silent" };
+  if (mode === "ts") env.BRIKLAB_NATIVE = "0";
+  else {
+    delete env.BRIKLAB_NATIVE;
+    env.BRIKLAB_JSTC_NATIVE_MIN_ARGS = "1";
+  }
+  const child = spawnSync(process.execPath, [fileURLToPath(import.meta.url), "--child", mode], {
+    env,
+    encoding: "utf8",
+    maxBuffer: 64 * 1024 * 1024,
+    stdio: ["ignore", "pipe", "inherit"],
+  });
+  if (child.status !== 0) {
+    console.error(`[test] ${mode} run failed with exit code ${child.status}.`);
+    process.exit(1);
+  }
+  return JSON.parse(child.stdout);
+}
+
+async function main() {
+  if (argv[0] === "--child") {
+    process.stdout.write(JSON.stringify(await results()));
+    return;
+  }
+  const ts = spawnMode("ts");
+  const nat = spawnMode("native");
+  const missing = Object.keys(nat.natives).filter((m) => !nat.natives[m]);
+  if (missing.length > 0) {
+    console.error(`[test] native addon not loaded for: ${missing.join(", ")}. Run pnpm build:native first.`);
+  }
+  let mismatches = 0;
+  for (const [name, expected] of Object.entries(ts.out)) {
+    const a = JSON.stringify(expected);
+    const b = JSON.stringify(nat.out[name]);
+    if (a === b) continue;
+    console.error(`[test] ${name}: ts ${a.slice(0, 200)} != native ${String(b).slice(0, 200)}`);
+    mismatches++;
+  }
+  const total = Object.keys(ts.out).length;
+  console.log(`[test] ${total - mismatches}/${total} results match the TS path.`);
+  if (missing.length > 0 || mismatches > 0) process.exit(1);
+}
+//#endregion
+
+main();